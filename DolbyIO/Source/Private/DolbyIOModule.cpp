@@ -2,6 +2,7 @@
 
 #include "Utils/DolbyIOCppSdk.h"
 #include "Utils/DolbyIOLogging.h"
+#include "Utils/DolbyIOMemory.h"
 
 #include "HAL/PlatformProcess.h"
 #include "Interfaces/IPluginManager.h"
@@ -15,15 +16,12 @@ class FDolbyIOModule final : public IModuleInterface
 public:
 	void StartupModule() override
 	{
+		using namespace dolbyio::comms;
+		// The SDK must allocate through the allocator from the start, so it is installed as soon as it is loaded
+		const app_allocator Allocator = DolbyIO::GetSdkAllocator();
 		FString BaseDir =
 		    FPaths::Combine(*IPluginManager::Get().FindPlugin("DolbyIO")->GetBaseDir(), TEXT("sdk-release"));
 #if PLATFORM_WINDOWS
-		using namespace dolbyio::comms;
-		app_allocator Allocator{
-		    ::operator new,
-		    [](std::size_t Count, std::size_t Al) { return ::operator new(Count, static_cast<std::align_val_t>(Al)); },
-		    ::operator delete,
-		    [](void* Ptr, std::size_t Al) { ::operator delete(Ptr, static_cast<std::align_val_t>(Al)); }};
 		// Add this here as I am not sure how Windows paths are interpreted (do I need the backslash)
 		BaseDir = FPaths::Combine(BaseDir, TEXT("bin"));
 		LoadDll(BaseDir, "avutil-57.dll");
@@ -39,17 +37,19 @@ public:
 		LoadDll(BaseDir, "dvdnr.dll");
 		LoadDll(BaseDir, "dlb_vidseg_c_api.dll");
 		LoadDll(BaseDir, "video_processor.dll");
-		dolbyio::comms::plugin::video_processor::set_app_allocator(Allocator);
+		plugin::video_processor::set_app_allocator(Allocator);
 #elif PLATFORM_MAC
 		LoadDll(BaseDir, "lib/libdvclient.dylib");
 		LoadDll(BaseDir, "lib/libdolbyio_comms_media.dylib");
 		LoadDll(BaseDir, "lib/libdolbyio_comms_sdk.dylib");
+		sdk::set_app_allocator(Allocator);
 		LoadDll(BaseDir, "lib/libopencv_core.4.5.dylib");
 		LoadDll(BaseDir, "lib/libopencv_imgproc.4.5.dylib");
 		LoadDll(BaseDir, "lib/libopencv_imgcodecs.4.5.dylib");
 		LoadDll(BaseDir, "lib/libdlb_vidseg_c_api.dylib");
 		LoadDll(BaseDir, "lib/libdvdnr.dylib");
 		LoadDll(BaseDir, "lib/libvideo_processor.dylib");
+		plugin::video_processor::set_app_allocator(Allocator);
 #elif PLATFORM_LINUX
 		BaseDir += "-ubuntu-20.04-clang10-libc++10";
 		LoadDll(BaseDir, "lib/libavutil.so.57");
@@ -58,6 +58,9 @@ public:
 		LoadDll(BaseDir, "lib/libdvclient.so");
 		LoadDll(BaseDir, "lib/libdolbyio_comms_media.so");
 		LoadDll(BaseDir, "lib/libdolbyio_comms_sdk.so");
+		sdk::set_app_allocator(Allocator);
+#else
+		sdk::set_app_allocator(Allocator);
 #endif
 	}
 
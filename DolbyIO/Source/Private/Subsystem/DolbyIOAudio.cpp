@@ -2,17 +2,19 @@
 
 #include "DolbyIO.h"
 
+#include "Utils/DolbyIOAudioLevels.h"
 #include "Utils/DolbyIOBroadcastEvent.h"
 #include "Utils/DolbyIOConversions.h"
 #include "Utils/DolbyIOErrorHandler.h"
 #include "Utils/DolbyIOLogging.h"
+#include "Utils/DolbyIOTrace.h"
 
 using namespace dolbyio::comms;
 using namespace DolbyIO;
 
 void UDolbyIOSubsystem::SetSpatialEnvironment()
 {
-	if (!IsConnectedAsActive() || !IsSpatialAudio())
+	if (!IsConnectedAsActive() || !IsSpatialAudio() || !Sdk)
 	{
 		return;
 	}
@@ -66,27 +68,27 @@ void UDolbyIOSubsystem::UnmuteOutput()
 
 void UDolbyIOSubsystem::ToggleInputMute()
 {
-	if (IsConnectedAsActive())
+	if (IsConnectedAsActive() && Sdk)
 	{
 		Sdk->conference()
 		    .mute(bIsInputMuted)
-		    .on_error(DLB_ERROR_HANDLER(bIsInputMuted ? OnMuteInputError : OnUnmuteInputError));
+		    .on_error(bIsInputMuted ? DLB_ERROR_HANDLER(OnMuteInputError) : DLB_ERROR_HANDLER(OnUnmuteInputError));
 	}
 }
 
 void UDolbyIOSubsystem::ToggleOutputMute()
 {
-	if (IsConnected() && ConnectionMode != EDolbyIOConnectionMode::ListenerRTS)
+	if (IsConnected() && ConnectionMode != EDolbyIOConnectionMode::ListenerRTS && Sdk)
 	{
 		Sdk->conference()
 		    .mute_output(bIsOutputMuted)
-		    .on_error(DLB_ERROR_HANDLER(bIsOutputMuted ? OnMuteOutputError : OnUnmuteOutputError));
+		    .on_error(bIsOutputMuted ? DLB_ERROR_HANDLER(OnMuteOutputError) : DLB_ERROR_HANDLER(OnUnmuteOutputError));
 	}
 }
 
 void UDolbyIOSubsystem::MuteParticipant(const FString& ParticipantID)
 {
-	if (!IsConnected() || ParticipantID == LocalParticipantID)
+	if (!IsConnected() || ParticipantID == LocalParticipantID || !Sdk)
 	{
 		return;
 	}
@@ -97,7 +99,7 @@ void UDolbyIOSubsystem::MuteParticipant(const FString& ParticipantID)
 
 void UDolbyIOSubsystem::UnmuteParticipant(const FString& ParticipantID)
 {
-	if (!IsConnected() || ParticipantID == LocalParticipantID)
+	if (!IsConnected() || ParticipantID == LocalParticipantID || !Sdk)
 	{
 		return;
 	}
@@ -129,16 +131,38 @@ void UDolbyIOSubsystem::SetAudioCaptureMode(EDolbyIONoiseReduction NoiseReductio
 
 void UDolbyIOSubsystem::Handle(const active_speaker_changed& Event)
 {
+	DLB_TRACE_HANDLER("Handle active_speaker_changed");
+	// The video memory budget needs the active speakers even when nothing listens to the event
+	const bool bHasListeners = bHasActiveSpeakersListeners;
 	TArray<FString> ActiveSpeakers;
-	for (const std::string& Speaker : Event.active_speakers)
 	{
-		ActiveSpeakers.Add(ToFString(Speaker));
+		FScopeLock Lock{&ActiveSpeakersLock};
+		ActiveSpeakerIDs.Reset();
+		for (const std::string& Speaker : Event.active_speakers)
+		{
+			FString ID = ToFString(Speaker);
+			if (bHasListeners)
+			{
+				ActiveSpeakers.Add(ID);
+			}
+			ActiveSpeakerIDs.Add(MoveTemp(ID));
+		}
+	}
+	if (bHasListeners)
+	{
+		DLB_BROADCAST(OnActiveSpeakersChanged, MoveTemp(ActiveSpeakers));
 	}
-	BroadcastEvent(OnActiveSpeakersChanged, ActiveSpeakers);
 }
 
 void UDolbyIOSubsystem::Handle(const audio_levels& Event)
 {
+	DLB_TRACE_HANDLER("Handle audio_levels");
+	AudioLevelTable->Update(Event);
+	if (!bHasAudioLevelsListeners)
+	{
+		return;
+	}
+
 	TArray<FString> ActiveSpeakers;
 	TArray<float> AudioLevels;
 	for (const audio_level& Level : Event.levels)
@@ -146,5 +170,10 @@ void UDolbyIOSubsystem::Handle(const audio_levels& Event)
 		ActiveSpeakers.Add(ToFString(Level.participant_id));
 		AudioLevels.Add(Level.level);
 	}
-	BroadcastEvent(OnAudioLevelsChanged, ActiveSpeakers, AudioLevels);
+	DLB_BROADCAST(OnAudioLevelsChanged, MoveTemp(ActiveSpeakers), MoveTemp(AudioLevels));
+}
+
+float UDolbyIOSubsystem::GetAudioLevel(const FString& ParticipantID)
+{
+	return IsConnected() ? AudioLevelTable->GetAudioLevel(ParticipantID) : 0.f;
 }
@@ -2,10 +2,13 @@
 
 #include "DolbyIO.h"
 
+#include "DolbyIOLocalBackend.h"
 #include "Utils/DolbyIOBroadcastEvent.h"
 #include "Utils/DolbyIOConversions.h"
 #include "Utils/DolbyIOErrorHandler.h"
 #include "Utils/DolbyIOLogging.h"
+#include "Utils/DolbyIOPerformance.h"
+#include "Utils/DolbyIOTrace.h"
 
 using namespace dolbyio::comms;
 using namespace DolbyIO;
@@ -17,7 +20,7 @@ void UDolbyIOSubsystem::Connect(const FString& ConferenceName, const FString& Us
 {
 	using namespace dolbyio::comms::services;
 
-	if (!CanConnect(OnConnectError))
+	if (!CanConnect(OnConnectError, OnConnectErrorNative))
 	{
 		return;
 	}
@@ -39,6 +42,11 @@ void UDolbyIOSubsystem::Connect(const FString& ConferenceName, const FString& Us
 	UserInfo.externalId = ToStdString(ExternalID);
 	UserInfo.avatarUrl = ToStdString(AvatarURL);
 	EmptyRemoteParticipants();
+	if (LocalBackend)
+	{
+		LocalBackend->Connect();
+		return;
+	}
 
 	Sdk->session()
 	    .open(MoveTemp(UserInfo))
@@ -93,7 +101,7 @@ void UDolbyIOSubsystem::Connect(const FString& ConferenceName, const FString& Us
 
 void UDolbyIOSubsystem::DemoConference()
 {
-	if (!CanConnect(OnDemoConferenceError))
+	if (!CanConnect(OnDemoConferenceError, OnDemoConferenceErrorNative))
 	{
 		return;
 	}
@@ -102,6 +110,11 @@ void UDolbyIOSubsystem::DemoConference()
 	ConnectionMode = EDolbyIOConnectionMode::Active;
 	SpatialAudioStyle = EDolbyIOSpatialAudioStyle::Shared;
 	EmptyRemoteParticipants();
+	if (LocalBackend)
+	{
+		LocalBackend->Connect();
+		return;
+	}
 
 	Sdk->session()
 	    .open({})
@@ -130,6 +143,11 @@ void UDolbyIOSubsystem::Disconnect()
 	}
 
 	DLB_UE_LOG("Disconnecting");
+	if (LocalBackend)
+	{
+		LocalBackend->Disconnect();
+		return;
+	}
 	Sdk->conference().leave().on_error(DLB_ERROR_HANDLER(OnDisconnectError));
 }
 
@@ -141,21 +159,33 @@ void UDolbyIOSubsystem::UpdateStatus(conference_status Status)
 	switch (ConferenceStatus)
 	{
 		case conference_status::joined:
-			BroadcastEvent(OnConnected, LocalParticipantID, ConferenceID);
+			DLB_BROADCAST(OnConnected, LocalParticipantID, ConferenceID);
 			break;
 		case conference_status::left:
 		case conference_status::error:
+			if (!Sdk) // local backend or replayed trace
+			{
+				DLB_BROADCAST(OnDisconnected);
+				break;
+			}
 			Sdk->session()
 			    .close()
-			    .then([this] { BroadcastEvent(OnDisconnected); })
+			    .then([this] { DLB_BROADCAST(OnDisconnected); })
 			    .on_error(DLB_ERROR_HANDLER(OnDisconnectError));
 			break;
 	}
 }
 
-bool UDolbyIOSubsystem::CanConnect(const FDolbyIOOnErrorDelegate& OnError) const
+void UDolbyIOSubsystem::Handle(const conference_status_updated& Event)
+{
+	DLB_TRACE_HANDLER("Handle conference_status_updated");
+	UpdateStatus(Event.status);
+}
+
+bool UDolbyIOSubsystem::CanConnect(const FDolbyIOOnErrorDelegate& OnError,
+                                   const FDolbyIOOnErrorNativeDelegate& OnErrorNative) const
 {
-	if (!Sdk)
+	if (!Sdk && !LocalBackend)
 	{
 		DLB_WARNING(OnError, "Cannot connect - not initialized");
 		return false;
@@ -180,8 +210,11 @@ bool UDolbyIOSubsystem::IsConnectedAsActive() const
 
 void UDolbyIOSubsystem::EmptyRemoteParticipants()
 {
-	FScopeLock Lock{&RemoteParticipantsLock};
-	RemoteParticipants.Empty();
+	{
+		FScopeLock Lock{&RemoteParticipantsLock};
+		RemoteParticipants.Empty();
+	}
+	AudioLevelTable->Reset();
 }
 
 TArray<FDolbyIOParticipantInfo> UDolbyIOSubsystem::GetParticipants()
@@ -197,7 +230,7 @@ TArray<FDolbyIOParticipantInfo> UDolbyIOSubsystem::GetParticipants()
 
 void UDolbyIOSubsystem::UpdateUserMetadata(const FString& UserName, const FString& AvatarURL)
 {
-	if (!IsConnected())
+	if (!IsConnected() || !Sdk)
 	{
 		return;
 	}
@@ -218,6 +251,12 @@ void UDolbyIOSubsystem::SendMessage(const FString& Message, const TArray<FString
 	}
 
 	DLB_UE_LOG("Sending message %s", *Message);
+	++PerformanceCounters->MessagesSent;
+	if (LocalBackend)
+	{
+		LocalBackend->SendMessage(Message, ParticipantIDs);
+		return;
+	}
 	std::vector<std::string> SdkParticipantIDs;
 	SdkParticipantIDs.reserve(ParticipantIDs.Num());
 	for (const FString& ID : ParticipantIDs)
@@ -231,6 +270,7 @@ void UDolbyIOSubsystem::SendMessage(const FString& Message, const TArray<FString
 
 void UDolbyIOSubsystem::Handle(const remote_participant_added& Event)
 {
+	DLB_TRACE_HANDLER("Handle remote_participant_added");
 	if (!Event.participant.status)
 	{
 		return;
@@ -244,13 +284,14 @@ void UDolbyIOSubsystem::Handle(const remote_participant_added& Event)
 		RemoteParticipants.Emplace(Info.UserID, Info);
 	}
 
-	BroadcastEvent(OnParticipantAdded, Info.Status, Info);
+	DLB_BROADCAST(OnParticipantAdded, Info.Status, Info);
 	BroadcastRemoteParticipantConnectedIfNecessary(Info);
 	ProcessBufferedVideoTracks(Info.UserID);
 }
 
 void UDolbyIOSubsystem::Handle(const remote_participant_updated& Event)
 {
+	DLB_TRACE_HANDLER("Handle remote_participant_updated");
 	if (!Event.participant.status)
 	{
 		return;
@@ -264,7 +305,10 @@ void UDolbyIOSubsystem::Handle(const remote_participant_updated& Event)
 		RemoteParticipants.FindOrAdd(Info.UserID) = Info;
 	}
 
-	BroadcastEvent(OnParticipantUpdated, Info.Status, Info);
+	if (bHasParticipantUpdatedListeners)
+	{
+		DLB_BROADCAST(OnParticipantUpdated, Info.Status, Info);
+	}
 	BroadcastRemoteParticipantConnectedIfNecessary(Info);
 	BroadcastRemoteParticipantDisconnectedIfNecessary(Info);
 }
@@ -273,7 +317,7 @@ void UDolbyIOSubsystem::BroadcastRemoteParticipantConnectedIfNecessary(const FDo
 {
 	if (ParticipantInfo.Status == EDolbyIOParticipantStatus::OnAir)
 	{
-		BroadcastEvent(OnRemoteParticipantConnected, ParticipantInfo);
+		DLB_BROADCAST(OnRemoteParticipantConnected, ParticipantInfo);
 	}
 }
 
@@ -283,12 +327,13 @@ void UDolbyIOSubsystem::BroadcastRemoteParticipantDisconnectedIfNecessary(
 	if (ParticipantInfo.Status == EDolbyIOParticipantStatus::Left ||
 	    ParticipantInfo.Status == EDolbyIOParticipantStatus::Kicked)
 	{
-		BroadcastEvent(OnRemoteParticipantDisconnected, ParticipantInfo);
+		DLB_BROADCAST(OnRemoteParticipantDisconnected, ParticipantInfo);
 	}
 }
 
 void UDolbyIOSubsystem::Handle(const local_participant_updated& Event)
 {
+	DLB_TRACE_HANDLER("Handle local_participant_updated");
 	if (!Event.participant.status)
 	{
 		return;
@@ -298,21 +343,23 @@ void UDolbyIOSubsystem::Handle(const local_participant_updated& Event)
 	DLB_UE_LOG("Local participant status updated: UserID=%s Name=%s ExternalID=%s Status=%s", *Info.UserID, *Info.Name,
 	           *Info.ExternalID, *ToString(*Event.participant.status));
 
-	BroadcastEvent(OnLocalParticipantUpdated, Info.Status, Info);
+	DLB_BROADCAST(OnLocalParticipantUpdated, Info.Status, Info);
 }
 
 void UDolbyIOSubsystem::Handle(const conference_message_received& Event)
 {
-	const FString Message = ToFString(Event.message);
+	DLB_TRACE_HANDLER("Handle conference_message_received");
+	++PerformanceCounters->MessagesReceived;
+	FString Message = ToFString(Event.message);
 	FScopeLock Lock{&RemoteParticipantsLock};
 	if (const FDolbyIOParticipantInfo* Sender = RemoteParticipants.Find(ToFString(Event.user_id)))
 	{
 		DLB_UE_LOG("Message received: \"%s\" from %s (%s)", *Message, *Sender->Name, *Sender->UserID);
-		BroadcastEvent(OnMessageReceived, Message, *Sender);
+		DLB_BROADCAST(OnMessageReceived, MoveTemp(Message), *Sender);
 	}
 	else
 	{
 		DLB_UE_LOG("Message received: %s from unknown participant", *Message);
-		BroadcastEvent(OnMessageReceived, Message, FDolbyIOParticipantInfo{});
+		DLB_BROADCAST(OnMessageReceived, MoveTemp(Message), FDolbyIOParticipantInfo{});
 	}
 }
@@ -7,6 +7,7 @@
 #include "Utils/DolbyIOConversions.h"
 #include "Utils/DolbyIOErrorHandler.h"
 #include "Utils/DolbyIOLogging.h"
+#include "Utils/DolbyIOTrace.h"
 
 using namespace dolbyio::comms;
 using namespace DolbyIO;
@@ -77,7 +78,7 @@ namespace DolbyIO
 					        Devices.Add(ToFDolbyIOAudioDevice(Device));
 				        }
 			        }
-			        BroadcastEvent(Subsystem.OnAudioInputDevicesReceived, Devices);
+			        DLB_BROADCAST(Subsystem.OnAudioInputDevicesReceived, MoveTemp(Devices));
 		        })
 		    .on_error(DLB_ERROR_HANDLER(Subsystem.OnGetAudioInputDevicesError));
 	}
@@ -98,7 +99,7 @@ namespace DolbyIO
 					        Devices.Add(ToFDolbyIOAudioDevice(Device));
 				        }
 			        }
-			        BroadcastEvent(Subsystem.OnAudioOutputDevicesReceived, Devices);
+			        DLB_BROADCAST(Subsystem.OnAudioOutputDevicesReceived, MoveTemp(Devices));
 		        })
 		    .on_error(DLB_ERROR_HANDLER(Subsystem.OnGetAudioOutputDevicesError));
 	}
@@ -113,13 +114,13 @@ namespace DolbyIO
 			        if (!Device)
 			        {
 				        DLB_UE_LOG("Got current audio input device - none");
-				        BroadcastEvent(Subsystem.OnCurrentAudioInputDeviceReceived, bIsDeviceNone,
-				                       FDolbyIOAudioDevice{});
+				        DLB_BROADCAST(Subsystem.OnCurrentAudioInputDeviceReceived, bIsDeviceNone,
+				                      FDolbyIOAudioDevice{});
 				        return;
 			        }
 			        DLB_UE_LOG("Got current audio input device - %s", *ToString(*Device));
-			        BroadcastEvent(Subsystem.OnCurrentAudioInputDeviceReceived, !bIsDeviceNone,
-			                       ToFDolbyIOAudioDevice(*Device));
+			        DLB_BROADCAST(Subsystem.OnCurrentAudioInputDeviceReceived, !bIsDeviceNone,
+			                      ToFDolbyIOAudioDevice(*Device));
 		        })
 		    .on_error(DLB_ERROR_HANDLER(Subsystem.OnGetCurrentAudioInputDeviceError));
 	}
@@ -134,13 +135,13 @@ namespace DolbyIO
 			        if (!Device)
 			        {
 				        DLB_UE_LOG("Got current audio output device - none");
-				        BroadcastEvent(Subsystem.OnCurrentAudioOutputDeviceReceived, bIsDeviceNone,
-				                       FDolbyIOAudioDevice{});
+				        DLB_BROADCAST(Subsystem.OnCurrentAudioOutputDeviceReceived, bIsDeviceNone,
+				                      FDolbyIOAudioDevice{});
 				        return;
 			        }
 			        DLB_UE_LOG("Got current audio output device - %s", *ToString(*Device));
-			        BroadcastEvent(Subsystem.OnCurrentAudioOutputDeviceReceived, !bIsDeviceNone,
-			                       ToFDolbyIOAudioDevice(*Device));
+			        DLB_BROADCAST(Subsystem.OnCurrentAudioOutputDeviceReceived, !bIsDeviceNone,
+			                      ToFDolbyIOAudioDevice(*Device));
 		        })
 		    .on_error(DLB_ERROR_HANDLER(Subsystem.OnGetCurrentAudioOutputDeviceError));
 	}
@@ -198,7 +199,7 @@ namespace DolbyIO
 				                   *ToFString(Device.unique_id));
 				        Devices.Add(ToFDolbyIOVideoDevice(Device));
 			        }
-			        BroadcastEvent(Subsystem.OnVideoDevicesReceived, Devices);
+			        DLB_BROADCAST(Subsystem.OnVideoDevicesReceived, MoveTemp(Devices));
 		        })
 		    .on_error(DLB_ERROR_HANDLER(Subsystem.OnGetVideoDevicesError));
 	}
@@ -213,12 +214,12 @@ namespace DolbyIO
 			        if (!Device)
 			        {
 				        DLB_UE_LOG("Got current video device - none");
-				        BroadcastEvent(Subsystem.OnCurrentVideoDeviceReceived, bIsDeviceNone, FDolbyIOVideoDevice{});
+				        DLB_BROADCAST(Subsystem.OnCurrentVideoDeviceReceived, bIsDeviceNone, FDolbyIOVideoDevice{});
 				        return;
 			        }
 			        DLB_UE_LOG("Got current video device - %s", *ToString(*Device));
-			        BroadcastEvent(Subsystem.OnCurrentVideoDeviceReceived, !bIsDeviceNone,
-			                       ToFDolbyIOVideoDevice(*Device));
+			        DLB_BROADCAST(Subsystem.OnCurrentVideoDeviceReceived, !bIsDeviceNone,
+			                      ToFDolbyIOVideoDevice(*Device));
 		        })
 		    .on_error(DLB_ERROR_HANDLER(Subsystem.OnGetCurrentVideoDeviceError));
 	}
@@ -226,15 +227,16 @@ namespace DolbyIO
 
 void UDolbyIOSubsystem::Handle(const audio_device_changed& Event)
 {
+	DLB_TRACE_HANDLER("Handle audio_device_changed");
 	using namespace DolbyIO;
 
 	if (!Event.device)
 	{
 		DLB_UE_LOG("Audio device changed for direction: %s to no device", *ToString(Event.utilized_direction));
 		if (Event.utilized_direction == audio_device::direction::input)
-			BroadcastEvent(OnCurrentAudioInputDeviceChanged, bIsDeviceNone, FDolbyIOAudioDevice{});
+			DLB_BROADCAST(OnCurrentAudioInputDeviceChanged, bIsDeviceNone, FDolbyIOAudioDevice{});
 		else
-			BroadcastEvent(OnCurrentAudioOutputDeviceChanged, bIsDeviceNone, FDolbyIOAudioDevice{});
+			DLB_BROADCAST(OnCurrentAudioOutputDeviceChanged, bIsDeviceNone, FDolbyIOAudioDevice{});
 		return;
 	}
 	Sdk->device_management()
@@ -248,11 +250,11 @@ void UDolbyIOSubsystem::Handle(const audio_device_changed& Event)
 				        DLB_UE_LOG("Audio device changed for direction: %s to device - %s",
 				                   *ToString(Event.utilized_direction), *ToString(Device));
 				        if (Event.utilized_direction == audio_device::direction::input)
-					        BroadcastEvent(OnCurrentAudioInputDeviceChanged, !bIsDeviceNone,
-					                       ToFDolbyIOAudioDevice(Device));
+					        DLB_BROADCAST(OnCurrentAudioInputDeviceChanged, !bIsDeviceNone,
+					                      ToFDolbyIOAudioDevice(Device));
 				        else
-					        BroadcastEvent(OnCurrentAudioOutputDeviceChanged, !bIsDeviceNone,
-					                       ToFDolbyIOAudioDevice(Device));
+					        DLB_BROADCAST(OnCurrentAudioOutputDeviceChanged, !bIsDeviceNone,
+					                      ToFDolbyIOAudioDevice(Device));
 				        return;
 			        }
 	        })
@@ -0,0 +1,581 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOEventTrace.h"
+
+#include "Utils/DolbyIOConversions.h"
+#include "Utils/DolbyIOLogging.h"
+#include "Video/DolbyIOSyntheticVideoFrame.h"
+#include "Video/DolbyIOVideoSink.h"
+
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/Archive.h"
+#include "Serialization/MemoryReader.h"
+
+#include <type_traits>
+
+using namespace dolbyio::comms;
+using namespace DolbyIO;
+
+namespace
+{
+	constexpr uint32 TraceMagic = 0x54424C44; // "DLBT"
+	constexpr uint32 TraceVersion = 1;
+
+	enum class ERecordType : uint8
+	{
+		ConferenceStatus,
+		ActiveSpeakers,
+		AudioLevels,
+		Message,
+		LocalParticipantUpdated,
+		RemoteParticipantAdded,
+		RemoteParticipantUpdated,
+		VideoTrackAdded,
+		VideoTrackRemoved,
+		Vfs,
+		VideoFrame,
+	};
+
+	constexpr int NumFrameVariants = 4;
+
+	// Each function both writes and reads a type, depending on the direction of the archive. Types from other
+	// namespaces are declared first so that the templates below find them.
+	void Serialize(FArchive& Ar, std::string& String);
+	void Serialize(FArchive& Ar, audio_level& Level);
+
+	template <class T> std::enable_if_t<std::is_arithmetic_v<T>> Serialize(FArchive& Ar, T& Value)
+	{
+		Ar << Value;
+	}
+
+	template <class T> std::enable_if_t<std::is_enum_v<T>> Serialize(FArchive& Ar, T& Value)
+	{
+		int32 Int = static_cast<int32>(Value);
+		Ar << Int;
+		Value = static_cast<T>(Int);
+	}
+
+	void Serialize(FArchive& Ar, std::string& String)
+	{
+		int32 Size = static_cast<int32>(String.size());
+		Ar << Size;
+		if (Ar.IsLoading())
+		{
+			if (Size < 0 || Size > Ar.TotalSize() - Ar.Tell())
+			{
+				Ar.SetError();
+				return;
+			}
+			String.resize(Size);
+		}
+		Ar.Serialize(String.data(), Size);
+	}
+
+	template <class T> void Serialize(FArchive& Ar, std::optional<T>& Optional)
+	{
+		bool bHasValue = Optional.has_value();
+		Ar << bHasValue;
+		if (bHasValue)
+		{
+			if (Ar.IsLoading())
+			{
+				Optional.emplace();
+			}
+			Serialize(Ar, *Optional);
+		}
+	}
+
+	template <class T> void Serialize(FArchive& Ar, std::vector<T>& Vector)
+	{
+		int32 Num = static_cast<int32>(Vector.size());
+		Ar << Num;
+		if (Ar.IsLoading())
+		{
+			if (Num < 0 || Num > Ar.TotalSize() - Ar.Tell())
+			{
+				Ar.SetError();
+				return;
+			}
+			Vector.resize(Num);
+		}
+		for (T& Item : Vector)
+		{
+			Serialize(Ar, Item);
+		}
+	}
+
+	void Serialize(FArchive& Ar, participant_info& Info)
+	{
+		Serialize(Ar, Info.user_id);
+		Serialize(Ar, Info.info.name);
+		Serialize(Ar, Info.info.external_id);
+		Serialize(Ar, Info.info.avatar_url);
+		Serialize(Ar, Info.status);
+		Serialize(Ar, Info.type);
+		Serialize(Ar, Info.is_sending_audio);
+		Serialize(Ar, Info.audible_locally);
+	}
+
+	void Serialize(FArchive& Ar, video_track& Track)
+	{
+		Serialize(Ar, Track.sdp_track_id);
+		Serialize(Ar, Track.peer_id);
+		Serialize(Ar, Track.is_screenshare);
+	}
+
+	void Serialize(FArchive& Ar, audio_level& Level)
+	{
+		Serialize(Ar, Level.participant_id);
+		Serialize(Ar, Level.level);
+	}
+
+	void Serialize(FArchive& Ar, utils::participant_track_map& Map)
+	{
+		int32 Num = static_cast<int32>(Map.size());
+		Ar << Num;
+		if (Ar.IsLoading())
+		{
+			for (int32 i = 0; i < Num && !Ar.IsError(); ++i)
+			{
+				std::string ParticipantID;
+				std::string VideoTrackID;
+				Serialize(Ar, ParticipantID);
+				Serialize(Ar, VideoTrackID);
+				Map.emplace(ParticipantID, ToSdkTrackMapValue(VideoTrackID));
+			}
+			return;
+		}
+		for (const auto& Item : Map)
+		{
+			std::string ParticipantID = Item.first;
+			std::string VideoTrackID = ToStdString(ToFDolbyIOVideoTrack(Item).TrackID);
+			Serialize(Ar, ParticipantID);
+			Serialize(Ar, VideoTrackID);
+		}
+	}
+
+	void Serialize(FArchive& Ar, conference_status_updated& Event)
+	{
+		Serialize(Ar, Event.status);
+	}
+	void Serialize(FArchive& Ar, active_speaker_changed& Event)
+	{
+		Serialize(Ar, Event.active_speakers);
+	}
+	void Serialize(FArchive& Ar, audio_levels& Event)
+	{
+		Serialize(Ar, Event.levels);
+	}
+	void Serialize(FArchive& Ar, conference_message_received& Event)
+	{
+		Serialize(Ar, Event.conference_id);
+		Serialize(Ar, Event.user_id);
+		Serialize(Ar, Event.message);
+	}
+	void Serialize(FArchive& Ar, local_participant_updated& Event)
+	{
+		Serialize(Ar, Event.participant);
+	}
+	void Serialize(FArchive& Ar, remote_participant_added& Event)
+	{
+		Serialize(Ar, Event.participant);
+	}
+	void Serialize(FArchive& Ar, remote_participant_updated& Event)
+	{
+		Serialize(Ar, Event.participant);
+	}
+	void Serialize(FArchive& Ar, remote_video_track_added& Event)
+	{
+		Serialize(Ar, Event.track);
+	}
+	void Serialize(FArchive& Ar, remote_video_track_removed& Event)
+	{
+		Serialize(Ar, Event.track);
+	}
+	void Serialize(FArchive& Ar, utils::vfs_event& Event)
+	{
+		Serialize(Ar, Event.new_enabled);
+		Serialize(Ar, Event.new_disabled);
+	}
+
+	ESyntheticVideoFormat GetVideoFormat(const video_frame& VideoFrame)
+	{
+		std::shared_ptr<video_frame_buffer> Buffer = VideoFrame.video_frame_buffer();
+		if (Buffer && Buffer->type() == video_frame_buffer::type::nv12)
+		{
+			return ESyntheticVideoFormat::NV12;
+		}
+		if (Buffer && Buffer->type() == video_frame_buffer::type::argb)
+		{
+			return ESyntheticVideoFormat::Argb;
+		}
+		return ESyntheticVideoFormat::I420;
+	}
+}
+
+namespace DolbyIO
+{
+	std::shared_ptr<FEventTraceRecorder> FEventTraceRecorder::Create(const FString& Path, bool bRecordFramePayloads)
+	{
+		FArchive* Writer = IFileManager::Get().CreateFileWriter(*Path);
+		if (!Writer)
+		{
+			return nullptr;
+		}
+
+		uint32 Magic = TraceMagic;
+		uint32 Version = TraceVersion;
+		*Writer << Magic << Version;
+		return std::shared_ptr<FEventTraceRecorder>(new FEventTraceRecorder(Path, Writer, bRecordFramePayloads));
+	}
+
+	FEventTraceRecorder::FEventTraceRecorder(const FString& Path, FArchive* Writer, bool bRecordFramePayloads)
+	    : Path(Path), Writer(Writer), StartCycles(FPlatformTime::Cycles64()), bRecordFramePayloads(bRecordFramePayloads)
+	{
+	}
+
+	FEventTraceRecorder::~FEventTraceRecorder()
+	{
+		Writer->Close();
+		delete Writer;
+	}
+
+	void FEventTraceRecorder::Write(uint8 Type, TFunctionRef<void(FArchive&)> SerializePayload)
+	{
+		int64 TimeUs = static_cast<int64>(FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles) * 1e6);
+		FScopeLock Lock{&WriterLock};
+		*Writer << Type << TimeUs;
+		SerializePayload(*Writer);
+		++NumRecords;
+	}
+
+#define DLB_DEFINE_RECORD(RecordType, Event)                                                                         \
+	void FEventTraceRecorder::Record(const Event& InEvent)                                                           \
+	{                                                                                                                \
+		Write(static_cast<uint8>(ERecordType::RecordType),                                                           \
+		      [&InEvent](FArchive& Ar) { Serialize(Ar, const_cast<Event&>(InEvent)); });                             \
+	}
+
+	DLB_DEFINE_RECORD(ConferenceStatus, conference_status_updated)
+	DLB_DEFINE_RECORD(ActiveSpeakers, active_speaker_changed)
+	DLB_DEFINE_RECORD(AudioLevels, audio_levels)
+	DLB_DEFINE_RECORD(Message, conference_message_received)
+	DLB_DEFINE_RECORD(LocalParticipantUpdated, local_participant_updated)
+	DLB_DEFINE_RECORD(RemoteParticipantAdded, remote_participant_added)
+	DLB_DEFINE_RECORD(RemoteParticipantUpdated, remote_participant_updated)
+	DLB_DEFINE_RECORD(VideoTrackAdded, remote_video_track_added)
+	DLB_DEFINE_RECORD(VideoTrackRemoved, remote_video_track_removed)
+	DLB_DEFINE_RECORD(Vfs, utils::vfs_event)
+
+	// Device events refer to the local hardware, which a replay could not reproduce anyway
+	void FEventTraceRecorder::Record(const audio_device_changed&) {}
+	void FEventTraceRecorder::Record(const screen_share_error&) {}
+
+	void FEventTraceRecorder::RecordFrame(const FString& VideoTrackID, const video_frame& VideoFrame)
+	{
+		ESyntheticVideoFormat Format = GetVideoFormat(VideoFrame);
+		TArray<uint8> Payload;
+		bool bHasPayload = bRecordFramePayloads && PackVideoFrame(VideoFrame, Format, Payload);
+
+		Write(static_cast<uint8>(ERecordType::VideoFrame),
+		      [&](FArchive& Ar)
+		      {
+			      std::string TrackID = ToStdString(VideoTrackID);
+			      int64 TimestampUs = VideoFrame.timestamp_us();
+			      int32 Width = VideoFrame.width();
+			      int32 Height = VideoFrame.height();
+			      Serialize(Ar, TrackID);
+			      Ar << TimestampUs << Width << Height;
+			      Serialize(Ar, Format);
+			      Ar << bHasPayload;
+			      if (bHasPayload)
+			      {
+				      Ar << Payload;
+			      }
+		      });
+	}
+
+	FEventTracePlayer::FEventTracePlayer(UDolbyIOSubsystem& Subsystem, TArray<uint8>&& Trace, float Speed)
+	    : Subsystem(Subsystem), Trace(MoveTemp(Trace)), Speed(Speed)
+	{
+		Thread = FRunnableThread::Create(this, TEXT("DolbyIOEventTracePlayer"));
+	}
+
+	FEventTracePlayer::~FEventTracePlayer()
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+	}
+
+	uint32 FEventTracePlayer::Run()
+	{
+		FMemoryReader Ar{Trace};
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		Ar << Magic << Version;
+		if (Magic != TraceMagic || Version != TraceVersion)
+		{
+			DLB_UE_LOG_BASE(Warning, "Cannot play trace - unsupported file format");
+			return 1;
+		}
+
+		const double Start = FPlatformTime::Seconds();
+		uint64 NumEvents = 0;
+		double MaxLag = 0;
+		while (!bIsStopping && !Ar.AtEnd())
+		{
+			uint8 Type;
+			int64 TimeUs;
+			Ar << Type << TimeUs;
+
+			if (Speed > 0)
+			{
+				const double Due = Start + TimeUs / 1e6 / Speed;
+				for (double Now = FPlatformTime::Seconds(); Now < Due && !bIsStopping; Now = FPlatformTime::Seconds())
+				{
+					FPlatformProcess::Sleep(static_cast<float>(FMath::Min(Due - Now, 0.1)));
+				}
+				MaxLag = FMath::Max(MaxLag, FPlatformTime::Seconds() - Due);
+			}
+
+			switch (static_cast<ERecordType>(Type))
+			{
+				case ERecordType::ConferenceStatus:
+					Dispatch<conference_status_updated>(Ar);
+					break;
+				case ERecordType::ActiveSpeakers:
+					Dispatch<active_speaker_changed>(Ar);
+					break;
+				case ERecordType::AudioLevels:
+					Dispatch<audio_levels>(Ar);
+					break;
+				case ERecordType::Message:
+					Dispatch<conference_message_received>(Ar);
+					break;
+				case ERecordType::LocalParticipantUpdated:
+					Dispatch<local_participant_updated>(Ar);
+					break;
+				case ERecordType::RemoteParticipantAdded:
+					Dispatch<remote_participant_added>(Ar);
+					break;
+				case ERecordType::RemoteParticipantUpdated:
+					Dispatch<remote_participant_updated>(Ar);
+					break;
+				case ERecordType::VideoTrackAdded:
+					Dispatch<remote_video_track_added>(Ar);
+					break;
+				case ERecordType::VideoTrackRemoved:
+					Dispatch<remote_video_track_removed>(Ar);
+					break;
+				case ERecordType::Vfs:
+					Dispatch<utils::vfs_event>(Ar);
+					break;
+				case ERecordType::VideoFrame:
+					DispatchFrame(Ar);
+					break;
+				default:
+					Ar.SetError();
+					break;
+			}
+			if (Ar.IsError())
+			{
+				DLB_UE_LOG_BASE(Warning, "Stopping trace playback - corrupt record at offset %lld", Ar.Tell());
+				break;
+			}
+			++NumEvents;
+		}
+
+		DLB_UE_LOG("Played %llu trace records (%u frames) in %.3f s, at most %.3f ms late", NumEvents, NumFrames,
+		           FPlatformTime::Seconds() - Start, MaxLag * 1000.0);
+		return 0;
+	}
+
+	void FEventTracePlayer::Stop()
+	{
+		bIsStopping = true;
+	}
+
+	template <class TEvent> void FEventTracePlayer::Dispatch(FArchive& Ar)
+	{
+		TEvent Event{};
+		Serialize(Ar, Event);
+		if (!Ar.IsError())
+		{
+			Subsystem.Handle(Event);
+		}
+	}
+
+	void FEventTracePlayer::DispatchFrame(FArchive& Ar)
+	{
+		std::string TrackID;
+		int64 TimestampUs;
+		int32 Width;
+		int32 Height;
+		ESyntheticVideoFormat Format;
+		bool bHasPayload;
+		Serialize(Ar, TrackID);
+		Ar << TimestampUs << Width << Height;
+		Serialize(Ar, Format);
+		Ar << bHasPayload;
+		TArray<uint8> Payload;
+		if (bHasPayload)
+		{
+			Ar << Payload;
+		}
+		if (Ar.IsError() || Width <= 0 || Height <= 0 || Format > ESyntheticVideoFormat::Argb)
+		{
+			Ar.SetError();
+			return;
+		}
+
+		std::shared_ptr<video_sink> Sink;
+		{
+			FScopeLock Lock{&Subsystem.VideoSinksLock};
+			if (std::shared_ptr<FVideoSink>* Found = Subsystem.VideoSinks.Find(ToFString(TrackID)))
+			{
+				Sink = *Found;
+			}
+		}
+		if (!Sink)
+		{
+			return;
+		}
+
+		++NumFrames;
+		if (bHasPayload && Payload.Num() == GetPackedVideoFrameSize(Format, Width, Height))
+		{
+			FSyntheticVideoFrame Frame{Format, Width, Height, MoveTemp(Payload)};
+			Frame.SetTimestamp(TimestampUs);
+			Sink->handle_frame(Frame);
+			return;
+		}
+
+		TArray<std::shared_ptr<FSyntheticVideoFrame>>& Frames =
+		    SyntheticFrames.FindOrAdd(MakeTuple(static_cast<uint8>(Format), Width, Height));
+		if (!Frames.Num())
+		{
+			for (int i = 0; i < NumFrameVariants; ++i)
+			{
+				Frames.Add(std::make_shared<FSyntheticVideoFrame>(Format, Width, Height, i));
+			}
+		}
+		FSyntheticVideoFrame& Frame = *Frames[NumFrames % NumFrameVariants];
+		Frame.SetTimestamp(TimestampUs);
+		Sink->handle_frame(Frame);
+	}
+}
+
+void UDolbyIOSubsystem::StartTraceRecording(const FString& Path, bool bRecordFramePayloads)
+{
+	StopTraceRecording();
+
+	std::shared_ptr<FEventTraceRecorder> Recorder = FEventTraceRecorder::Create(Path, bRecordFramePayloads);
+	if (!Recorder)
+	{
+		DLB_UE_LOG_BASE(Warning, "Cannot record trace - failed to open %s", *Path);
+		return;
+	}
+
+	DLB_UE_LOG("Recording trace to %s%s", *Path, bRecordFramePayloads ? TEXT(" with frame payloads") : TEXT(""));
+	std::atomic_store(&TraceRecorder, Recorder);
+	FScopeLock Lock{&VideoSinksLock};
+	for (auto& Sink : VideoSinks)
+	{
+		Sink.Value->SetTraceRecorder(Recorder);
+	}
+}
+
+void UDolbyIOSubsystem::StopTraceRecording()
+{
+	std::shared_ptr<FEventTraceRecorder> Recorder = std::atomic_exchange(&TraceRecorder, {});
+	if (!Recorder)
+	{
+		return;
+	}
+
+	{
+		FScopeLock Lock{&VideoSinksLock};
+		for (auto& Sink : VideoSinks)
+		{
+			Sink.Value->SetTraceRecorder(nullptr);
+		}
+	}
+	DLB_UE_LOG("Recorded %llu trace records to %s", Recorder->GetNumRecords(), *Recorder->GetPath());
+}
+
+void UDolbyIOSubsystem::PlayTrace(const FString& Path, float Speed)
+{
+	// Replayed events would act on the live session, e.g. a recorded left status would close it
+	if (Sdk)
+	{
+		DLB_UE_LOG_BASE(Warning, "Cannot play trace - the SDK is initialized, traces can only be played offline");
+		return;
+	}
+	TracePlayer.Reset();
+
+	TArray<uint8> Trace;
+	if (!FFileHelper::LoadFileToArray(Trace, *Path))
+	{
+		DLB_UE_LOG_BASE(Warning, "Cannot play trace - failed to read %s", *Path);
+		return;
+	}
+
+	DLB_UE_LOG("Playing trace %s at speed %f", *Path, Speed);
+	TracePlayer = MakeShared<FEventTracePlayer>(*this, MoveTemp(Trace), Speed);
+}
+
+namespace
+{
+	UDolbyIOSubsystem* FindSubsystem(UWorld* World)
+	{
+		UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+		return GameInstance ? GameInstance->GetSubsystem<UDolbyIOSubsystem>() : nullptr;
+	}
+
+	FAutoConsoleCommandWithWorldAndArgs RecordTraceCommand{
+	    TEXT("DolbyIO.Trace.Record"),
+	    TEXT("Records the events handled by the Dolby.io subsystem to a trace file. Arguments: <Path> "
+	         "[RecordFramePayloads=0]"),
+	    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+	        [](const TArray<FString>& Args, UWorld* World)
+	        {
+		        UDolbyIOSubsystem* Subsystem = FindSubsystem(World);
+		        if (Subsystem && Args.Num() > 0)
+		        {
+			        Subsystem->StartTraceRecording(Args[0], Args.Num() > 1 && FCString::Atoi(*Args[1]) != 0);
+		        }
+	        })};
+
+	FAutoConsoleCommandWithWorldAndArgs StopTraceCommand{
+	    TEXT("DolbyIO.Trace.StopRecording"), TEXT("Stops recording a trace started with DolbyIO.Trace.Record."),
+	    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+	        [](const TArray<FString>&, UWorld* World)
+	        {
+		        if (UDolbyIOSubsystem* Subsystem = FindSubsystem(World))
+		        {
+			        Subsystem->StopTraceRecording();
+		        }
+	        })};
+
+	FAutoConsoleCommandWithWorldAndArgs PlayTraceCommand{
+	    TEXT("DolbyIO.Trace.Play"),
+	    TEXT("Replays a trace file through the Dolby.io subsystem, which must not have initialized the SDK. Arguments: "
+	         "<Path> [Speed=1], where a speed of 0 replays events as fast as possible."),
+	    FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+	        [](const TArray<FString>& Args, UWorld* World)
+	        {
+		        UDolbyIOSubsystem* Subsystem = FindSubsystem(World);
+		        if (Subsystem && Args.Num() > 0)
+		        {
+			        Subsystem->PlayTrace(Args[0], Args.Num() > 1 ? FCString::Atof(*Args[1]) : 1.f);
+		        }
+	        })};
+}
@@ -0,0 +1,103 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "DolbyIO.h"
+#include "Utils/DolbyIOCppSdk.h"
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/Runnable.h"
+#include "Templates/Function.h"
+#include "Templates/Tuple.h"
+
+#include <atomic>
+#include <memory>
+
+class FArchive;
+class FRunnableThread;
+
+namespace DolbyIO
+{
+	class FSyntheticVideoFrame;
+
+	// Writes the SDK events handled by the subsystem and the frames delivered to video sinks to a binary trace file,
+	// which FEventTracePlayer can replay. Frame payloads are only written if requested since they are large.
+	class FEventTraceRecorder final
+	{
+	public:
+		static std::shared_ptr<FEventTraceRecorder> Create(const FString& Path, bool bRecordFramePayloads);
+		~FEventTraceRecorder();
+
+		void Record(const dolbyio::comms::conference_status_updated& Event);
+		void Record(const dolbyio::comms::active_speaker_changed& Event);
+		void Record(const dolbyio::comms::audio_device_changed& Event);
+		void Record(const dolbyio::comms::audio_levels& Event);
+		void Record(const dolbyio::comms::conference_message_received& Event);
+		void Record(const dolbyio::comms::local_participant_updated& Event);
+		void Record(const dolbyio::comms::remote_participant_added& Event);
+		void Record(const dolbyio::comms::remote_participant_updated& Event);
+		void Record(const dolbyio::comms::remote_video_track_added& Event);
+		void Record(const dolbyio::comms::remote_video_track_removed& Event);
+		void Record(const dolbyio::comms::screen_share_error& Event);
+		void Record(const dolbyio::comms::utils::vfs_event& Event);
+		void RecordFrame(const FString& VideoTrackID, const dolbyio::comms::video_frame& VideoFrame);
+
+		const FString& GetPath() const
+		{
+			return Path;
+		}
+		uint64 GetNumRecords() const
+		{
+			return NumRecords;
+		}
+
+	private:
+		FEventTraceRecorder(const FString& Path, FArchive* Writer, bool bRecordFramePayloads);
+
+		void Write(uint8 Type, TFunctionRef<void(FArchive&)> SerializePayload);
+
+		const FString Path;
+		FArchive* const Writer;
+		FCriticalSection WriterLock;
+		const uint64 StartCycles;
+		uint64 NumRecords = 0;
+		const bool bRecordFramePayloads;
+	};
+
+	// Feeds a trace written by FEventTraceRecorder to the subsystem's handlers and video sinks on its own thread, at
+	// the recorded pace multiplied by Speed or as fast as possible if Speed is 0.
+	class FEventTracePlayer final : public FRunnable
+	{
+	public:
+		FEventTracePlayer(UDolbyIOSubsystem& Subsystem, TArray<uint8>&& Trace, float Speed);
+		~FEventTracePlayer();
+
+	private:
+		uint32 Run() override;
+		void Stop() override;
+
+		template <class TEvent> void Dispatch(FArchive& Ar);
+		void DispatchFrame(FArchive& Ar);
+
+		UDolbyIOSubsystem& Subsystem;
+		const TArray<uint8> Trace;
+		const float Speed;
+		FRunnableThread* Thread;
+		std::atomic<bool> bIsStopping{false};
+		// Frames stand in for the recorded ones when the trace has no payloads
+		TMap<TTuple<uint8, int, int>, TArray<std::shared_ptr<FSyntheticVideoFrame>>> SyntheticFrames;
+		uint32 NumFrames = 0;
+	};
+}
+
+template <class TEvent> void UDolbyIOSubsystem::HandleAndRecord(const TEvent& Event)
+{
+	if (std::shared_ptr<DolbyIO::FEventTraceRecorder> Recorder = std::atomic_load(&TraceRecorder))
+	{
+		Recorder->Record(Event);
+	}
+	Handle(Event);
+}
@@ -3,15 +3,23 @@
 #include "DolbyIO.h"
 
 #include "DolbyIODevices.h"
+#include "DolbyIOEventTrace.h"
+#include "DolbyIOLocalBackend.h"
+#include "Utils/DolbyIOAudioLevels.h"
 #include "Utils/DolbyIOBroadcastEvent.h"
 #include "Utils/DolbyIOConversions.h"
 #include "Utils/DolbyIOErrorHandler.h"
 #include "Utils/DolbyIOLogging.h"
+#include "Utils/DolbyIOMemory.h"
+#include "Utils/DolbyIOPerformance.h"
 #include "Video/DolbyIOVideoFrameHandler.h"
 #include "Video/DolbyIOVideoSink.h"
+#include "Video/DolbyIOVideoTexturePool.h"
 
+#include "Async/Async.h"
 #include "Engine/GameInstance.h"
 #include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/EngineVersion.h"
 #include "Misc/Paths.h"
@@ -21,37 +29,75 @@ using namespace dolbyio::comms;
 using namespace dolbyio::comms::plugin;
 using namespace DolbyIO;
 
+namespace
+{
+	TAutoConsoleVariable<bool> CVarCoalesceActiveSpeakers{
+	    TEXT("DolbyIO.Events.CoalesceActiveSpeakers"), true,
+	    TEXT("Whether to only broadcast the latest OnActiveSpeakersChanged event received within a tick.")};
+	TAutoConsoleVariable<bool> CVarCoalesceAudioLevels{
+	    TEXT("DolbyIO.Events.CoalesceAudioLevels"), true,
+	    TEXT("Whether to only broadcast the latest OnAudioLevelsChanged event received within a tick.")};
+}
+
 void UDolbyIOSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
 	Super::Initialize(Collection);
 
 	ConferenceStatus = conference_status::destroyed;
+	PerformanceCounters = MakeShared<FPerformanceCounters>();
+	FVideoTexturePool::Get().AddUser();
+	EventQueue = MakeShared<FEventQueue>([this] { UpdateListeners(); });
+	EventQueue->CoalesceLatest(&OnActiveSpeakersChanged, TEXT("OnActiveSpeakersChanged"),
+	                           CVarCoalesceActiveSpeakers.AsVariable());
+	EventQueue->CoalesceLatest(&OnAudioLevelsChanged, TEXT("OnAudioLevelsChanged"),
+	                           CVarCoalesceAudioLevels.AsVariable());
+	AudioLevelTable = MakeShared<FAudioLevelTable>();
 
 	{
 		FScopeLock Lock{&VideoSinksLock};
 		VideoSinks.Emplace(LocalCameraTrackID, std::make_shared<FVideoSink>(LocalCameraTrackID));
 		VideoSinks.Emplace(LocalScreenshareTrackID, std::make_shared<FVideoSink>(LocalScreenshareTrackID));
+		VideoSinks[LocalScreenshareTrackID]->EnableDirtyRegionUploads();
 		LocalCameraFrameHandler = std::make_shared<FVideoFrameHandler>(VideoSinks[LocalCameraTrackID]);
 		LocalScreenshareFrameHandler = std::make_shared<FVideoFrameHandler>(VideoSinks[LocalScreenshareTrackID]);
+		PublishVideoSinks();
 	}
 
 	FTimerManager& TimerManager = GetGameInstance()->GetTimerManager();
 	TimerManager.SetTimer(LocationTimerHandle, this, &UDolbyIOSubsystem::SetLocationUsingFirstPlayer, 0.1, true);
 	TimerManager.SetTimer(RotationTimerHandle, this, &UDolbyIOSubsystem::SetRotationUsingFirstPlayer, 0.01, true);
+	TimerManager.SetTimer(VideoMemoryBudgetTimerHandle, this, &UDolbyIOSubsystem::ApplyVideoMemoryBudget,
+	                      VideoMemoryBudgetInterval, true);
+#if DLB_VIDEO_STATS
+	TimerManager.SetTimer(VideoStatsTimerHandle, this, &UDolbyIOSubsystem::UpdateVideoStats, VideoStatsInterval, true);
+#endif
 
-	BroadcastEvent(OnTokenNeeded);
+	DLB_BROADCAST(OnTokenNeeded);
 }
 
 void UDolbyIOSubsystem::Deinitialize()
 {
 	DLB_UE_LOG("Deinitializing");
 
+	// Stop the threads calling the handlers before taking locks they may be waiting for
+	LocalBackend.Reset();
+	TracePlayer.Reset();
+	StopTraceRecording();
+
 	FScopeLock Lock{&VideoSinksLock};
 	for (auto& Sink : VideoSinks)
 	{
 		Sink.Value->Disable(); // ignore new frames now on
 	}
 
+	const FVideoTexturePool::FStats& PoolStats = FVideoTexturePool::Get().GetStats();
+	DLB_UE_LOG("Video texture pool: hits %llu misses %llu evictions %llu pooled %d (%llu bytes)", PoolStats.Hits,
+	           PoolStats.Misses, PoolStats.Evictions, PoolStats.NumPooled,
+	           static_cast<uint64>(PoolStats.PooledBytes));
+	FVideoTexturePool::Get().RemoveUser();
+	const FSdkMemoryCounters& SdkMemory = GetSdkMemoryCounters();
+	DLB_UE_LOG("SDK memory: %lld bytes in %lld allocations", SdkMemory.GetBytes(), SdkMemory.GetAllocations());
+
 	Super::Deinitialize();
 }
 
@@ -110,8 +156,23 @@ void UDolbyIOSubsystem::SetLogSettings(EDolbyIOLogLevel SdkLogLevel, EDolbyIOLog
 
 void UDolbyIOSubsystem::SetToken(const FString& Token)
 {
-	if (!Sdk)
+	if (LocalBackend)
 	{
+		return;
+	}
+	if (!Sdk && FLocalBackend::IsEnabled())
+	{
+		DLB_UE_LOG("Initializing local backend");
+		LocalBackend = MakeShared<FLocalBackend>(*this);
+		LocalBackend->Initialize();
+	}
+	else if (!Sdk)
+	{
+		if (TracePlayer)
+		{
+			DLB_UE_LOG("Stopping trace playback to initialize the SDK");
+			TracePlayer.Reset();
+		}
 		DLB_UE_LOG("Initializing with token: %s", *Token);
 		AsyncTask(ENamedThreads::AnyThread, [this, Token] { Initialize(Token); });
 	}
@@ -139,7 +200,7 @@ void UDolbyIOSubsystem::Initialize(const FString& Token)
 		                                  {
 			                                  DLB_UE_LOG("Refresh token requested");
 			                                  RefreshTokenCb = TSharedPtr<refresh_token>(RefreshCb.release());
-			                                  BroadcastEvent(OnTokenNeeded);
+			                                  DLB_BROADCAST(OnTokenNeeded);
 		                                  })
 		                          .release());
 	}
@@ -152,7 +213,8 @@ void UDolbyIOSubsystem::Initialize(const FString& Token)
 	Devices = MakeShared<FDevices>(*this, Sdk->device_management());
 
 #define DLB_REGISTER_HANDLER(Service, Event) \
-	[this](event_handler_id) { return Sdk->Service().add_event_handler([this](const Event& Event) { Handle(Event); }); }
+	[this](event_handler_id)                 \
+	{ return Sdk->Service().add_event_handler([this](const Event& Event) { HandleAndRecord(Event); }); }
 
 	const FString ComponentName = "unreal-sdk";
 	const FString ComponentVersion = *IPluginManager::Get().FindPlugin("DolbyIO")->GetDescriptor().VersionName +
@@ -163,7 +225,7 @@ void UDolbyIOSubsystem::Initialize(const FString& Token)
 	        [this](sdk::component_data)
 	        {
 		        return Sdk->conference().add_event_handler([this](const conference_status_updated& Event)
-		                                                   { UpdateStatus(Event.status); });
+		                                                   { HandleAndRecord(Event); });
 	        })
 	    .then(DLB_REGISTER_HANDLER(conference, active_speaker_changed))
 	    .then(DLB_REGISTER_HANDLER(device_management, audio_device_changed))
@@ -189,14 +251,79 @@ void UDolbyIOSubsystem::Initialize(const FString& Token)
 	        [this]
 #endif
 	        {
-		        utils::vfs_event::add_event_handler(*Sdk, [this](const utils::vfs_event& Event) { Handle(Event); });
+		        utils::vfs_event::add_event_handler(*Sdk,
+		                                            [this](const utils::vfs_event& Event) { HandleAndRecord(Event); });
 
 		        DLB_UE_LOG("Initialized");
-		        BroadcastEvent(OnInitialized);
+		        DLB_BROADCAST(OnInitialized);
 	        })
 	    .on_error(DLB_ERROR_HANDLER(OnSetTokenError));
 }
 
+// Events which observers forward for as long as they are initialized, the ones only prepared for listeners are bound
+// by UpdateListenedBindings
+#define DLB_FOR_EACH_OBSERVED_EVENT(Macro)    \
+	Macro(OnTokenNeeded)                      \
+	Macro(OnInitialized)                      \
+	Macro(OnSetTokenError)                    \
+	Macro(OnConnected)                        \
+	Macro(OnConnectError)                     \
+	Macro(OnDemoConferenceError)              \
+	Macro(OnDisconnected)                     \
+	Macro(OnDisconnectError)                  \
+	Macro(OnSetSpatialEnvironmentScaleError)  \
+	Macro(OnMuteInputError)                   \
+	Macro(OnUnmuteInputError)                 \
+	Macro(OnMuteOutputError)                  \
+	Macro(OnUnmuteOutputError)                \
+	Macro(OnMuteParticipantError)             \
+	Macro(OnUnmuteParticipantError)           \
+	Macro(OnParticipantAdded)                 \
+	Macro(OnRemoteParticipantConnected)       \
+	Macro(OnRemoteParticipantDisconnected)    \
+	Macro(OnLocalParticipantUpdated)          \
+	Macro(OnVideoTrackAdded)                  \
+	Macro(OnVideoTrackRemoved)                \
+	Macro(OnVideoTrackEnabled)                \
+	Macro(OnVideoTrackDisabled)               \
+	Macro(OnVideoEnabled)                     \
+	Macro(OnEnableVideoError)                 \
+	Macro(OnVideoDisabled)                    \
+	Macro(OnDisableVideoError)                \
+	Macro(OnScreenshareSourcesReceived)       \
+	Macro(OnGetScreenshareSourcesError)       \
+	Macro(OnScreenshareStarted)               \
+	Macro(OnStartScreenshareError)            \
+	Macro(OnScreenshareStopped)               \
+	Macro(OnStopScreenshareError)             \
+	Macro(OnChangeScreenshareParametersError) \
+	Macro(OnCurrentScreenshareSourceReceived) \
+	Macro(OnGetCurrentScreenshareSourceError) \
+	Macro(OnSetLocalPlayerLocationError)      \
+	Macro(OnSetLocalPlayerRotationError)      \
+	Macro(OnSetRemotePlayerLocationError)     \
+	Macro(OnSetLogSettingsError)              \
+	Macro(OnAudioInputDevicesReceived)        \
+	Macro(OnGetAudioInputDevicesError)        \
+	Macro(OnAudioOutputDevicesReceived)       \
+	Macro(OnGetAudioOutputDevicesError)       \
+	Macro(OnCurrentAudioInputDeviceReceived)  \
+	Macro(OnGetCurrentAudioInputDeviceError)  \
+	Macro(OnCurrentAudioOutputDeviceReceived) \
+	Macro(OnGetCurrentAudioOutputDeviceError) \
+	Macro(OnVideoDevicesReceived)             \
+	Macro(OnGetVideoDevicesError)             \
+	Macro(OnCurrentVideoDeviceReceived)       \
+	Macro(OnGetCurrentVideoDeviceError)       \
+	Macro(OnCurrentAudioInputDeviceChanged)   \
+	Macro(OnSetAudioInputDeviceError)         \
+	Macro(OnCurrentAudioOutputDeviceChanged)  \
+	Macro(OnSetAudioOutputDeviceError)        \
+	Macro(OnUpdateUserMetadataError)          \
+	Macro(OnSetAudioCaptureModeError)         \
+	Macro(OnSendMessageError)                 \
+	Macro(OnMessageReceived)
+
 void UDolbyIOObserver::InitializeComponent()
 {
 	if (UWorld* World = GetWorld())
@@ -205,114 +332,86 @@ void UDolbyIOObserver::InitializeComponent()
 		{
 			if (UDolbyIOSubsystem* DolbyIOSubsystem = GameInstance->GetSubsystem<UDolbyIOSubsystem>())
 			{
-#define DLB_BIND(Event) DolbyIOSubsystem->Event.AddDynamic(this, &UDolbyIOObserver::Fwd##Event);
-				DLB_BIND(OnTokenNeeded);
-
-				DLB_BIND(OnInitialized);
-				DLB_BIND(OnSetTokenError);
-
-				DLB_BIND(OnConnected);
-				DLB_BIND(OnConnectError);
-				DLB_BIND(OnDemoConferenceError);
-
-				DLB_BIND(OnDisconnected);
-				DLB_BIND(OnDisconnectError);
-
-				DLB_BIND(OnSetSpatialEnvironmentScaleError);
-
-				DLB_BIND(OnMuteInputError);
-
-				DLB_BIND(OnUnmuteInputError);
-
-				DLB_BIND(OnMuteOutputError);
-
-				DLB_BIND(OnUnmuteOutputError);
-
-				DLB_BIND(OnMuteParticipantError);
-
-				DLB_BIND(OnUnmuteParticipantError);
-
-				DLB_BIND(OnParticipantAdded);
-				DLB_BIND(OnParticipantUpdated);
-				DLB_BIND(OnRemoteParticipantConnected);
-				DLB_BIND(OnRemoteParticipantDisconnected);
-
-				DLB_BIND(OnLocalParticipantUpdated);
-
-				DLB_BIND(OnVideoTrackAdded);
-
-				DLB_BIND(OnVideoTrackRemoved);
-
-				DLB_BIND(OnVideoTrackEnabled);
-
-				DLB_BIND(OnVideoTrackDisabled);
-
-				DLB_BIND(OnVideoEnabled);
-				DLB_BIND(OnEnableVideoError);
-
-				DLB_BIND(OnVideoDisabled);
-				DLB_BIND(OnDisableVideoError);
-
-				DLB_BIND(OnScreenshareSourcesReceived);
-				DLB_BIND(OnGetScreenshareSourcesError);
-
-				DLB_BIND(OnScreenshareStarted);
-				DLB_BIND(OnStartScreenshareError);
-
-				DLB_BIND(OnScreenshareStopped);
-				DLB_BIND(OnStopScreenshareError);
-
-				DLB_BIND(OnChangeScreenshareParametersError);
-
-				DLB_BIND(OnCurrentScreenshareSourceReceived);
-				DLB_BIND(OnGetCurrentScreenshareSourceError);
-
-				DLB_BIND(OnActiveSpeakersChanged);
-
-				DLB_BIND(OnAudioLevelsChanged);
-
-				DLB_BIND(OnSetLocalPlayerLocationError);
+				Subsystem = DolbyIOSubsystem;
+				DolbyIOSubsystem->Observers.Add(this);
+				UpdateListenedBindings();
 
-				DLB_BIND(OnSetLocalPlayerRotationError);
+#define DLB_BIND(Event) DolbyIOSubsystem->Event##Native.AddUObject(this, &UDolbyIOObserver::Fwd##Event);
+				DLB_FOR_EACH_OBSERVED_EVENT(DLB_BIND)
+#undef DLB_BIND
 
-				DLB_BIND(OnSetRemotePlayerLocationError);
-
-				DLB_BIND(OnSetLogSettingsError);
-
-				DLB_BIND(OnAudioInputDevicesReceived);
-				DLB_BIND(OnGetAudioInputDevicesError);
-
-				DLB_BIND(OnAudioOutputDevicesReceived);
-				DLB_BIND(OnGetAudioOutputDevicesError);
-
-				DLB_BIND(OnCurrentAudioInputDeviceReceived);
-				DLB_BIND(OnGetCurrentAudioInputDeviceError);
-
-				DLB_BIND(OnCurrentAudioOutputDeviceReceived);
-				DLB_BIND(OnGetCurrentAudioOutputDeviceError);
-
-				DLB_BIND(OnVideoDevicesReceived);
-				DLB_BIND(OnGetVideoDevicesError);
-
-				DLB_BIND(OnCurrentVideoDeviceReceived);
-				DLB_BIND(OnGetCurrentVideoDeviceError);
-
-				DLB_BIND(OnCurrentAudioInputDeviceChanged);
-				DLB_BIND(OnSetAudioInputDeviceError);
-
-				DLB_BIND(OnCurrentAudioOutputDeviceChanged);
-				DLB_BIND(OnSetAudioOutputDeviceError);
-
-				DLB_BIND(OnUpdateUserMetadataError);
+				FwdOnTokenNeeded();
+			}
+		}
+	}
+}
 
-				DLB_BIND(OnSetAudioCaptureModeError);
+void UDolbyIOObserver::UninitializeComponent()
+{
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = Subsystem.Get())
+	{
+		DolbyIOSubsystem->Observers.Remove(this);
+		// Native bindings are not deduplicated, so they must all go for a reinitialized component not to forward twice
+#define DLB_UNBIND(Event) DolbyIOSubsystem->Event##Native.RemoveAll(this);
+		DLB_FOR_EACH_OBSERVED_EVENT(DLB_UNBIND)
+		DLB_UNBIND(OnActiveSpeakersChanged)
+		DLB_UNBIND(OnAudioLevelsChanged)
+		DLB_UNBIND(OnParticipantUpdated)
+#undef DLB_UNBIND
+	}
+	Subsystem.Reset();
+	OnActiveSpeakersChangedHandle.Reset();
+	OnAudioLevelsChangedHandle.Reset();
+	OnParticipantUpdatedHandle.Reset();
+	Super::UninitializeComponent();
+}
 
-				DLB_BIND(OnSendMessageError);
+namespace
+{
+	template <class TDelegate, class TNativeDelegate, class TForwarder>
+	void BindWhileBound(UDolbyIOObserver* Observer, const TDelegate& Event, TNativeDelegate& NativeEvent,
+	                    TForwarder Forwarder, FDelegateHandle& Handle)
+	{
+		if (Event.IsBound() && !Handle.IsValid())
+		{
+			Handle = NativeEvent.AddUObject(Observer, Forwarder);
+		}
+		else if (!Event.IsBound() && Handle.IsValid())
+		{
+			NativeEvent.Remove(Handle);
+			Handle.Reset();
+		}
+	}
+}
 
-				DLB_BIND(OnMessageReceived);
+void UDolbyIOObserver::UpdateListenedBindings()
+{
+	if (UDolbyIOSubsystem* DolbyIOSubsystem = Subsystem.Get())
+	{
+#define DLB_BIND_WHILE_BOUND(Event) \
+	BindWhileBound(this, Event, DolbyIOSubsystem->Event##Native, &UDolbyIOObserver::Fwd##Event, Event##Handle);
+		DLB_BIND_WHILE_BOUND(OnActiveSpeakersChanged);
+		DLB_BIND_WHILE_BOUND(OnAudioLevelsChanged);
+		DLB_BIND_WHILE_BOUND(OnParticipantUpdated);
+#undef DLB_BIND_WHILE_BOUND
+	}
+}
 
-				FwdOnTokenNeeded();
-			}
+void UDolbyIOSubsystem::UpdateListeners()
+{
+	for (int32 i = Observers.Num() - 1; i >= 0; --i)
+	{
+		if (UDolbyIOObserver* Observer = Observers[i].Get())
+		{
+			Observer->UpdateListenedBindings();
+		}
+		else
+		{
+			Observers.RemoveAtSwap(i);
 		}
 	}
+
+	bHasActiveSpeakersListeners = OnActiveSpeakersChanged.IsBound() || OnActiveSpeakersChangedNative.IsBound();
+	bHasAudioLevelsListeners = OnAudioLevelsChanged.IsBound() || OnAudioLevelsChangedNative.IsBound();
+	bHasParticipantUpdatedListeners = OnParticipantUpdated.IsBound() || OnParticipantUpdatedNative.IsBound();
 }
@@ -0,0 +1,298 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOLoadTestCommandlet.h"
+
+#include "DolbyIO.h"
+#include "DolbyIOLocalBackend.h"
+#include "Utils/DolbyIOLogging.h"
+#include "Video/DolbyIOVideoTexture.h"
+
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "RenderingThread.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+void UDolbyIOLoadTestClient::Start(UGameInstance& InGameInstance, const FString& InUserName)
+{
+	GameInstance = &InGameInstance;
+	UserName = InUserName;
+	Subsystem = GameInstance->GetSubsystem<UDolbyIOSubsystem>();
+	Subsystem->OnInitializedNative.AddUObject(this, &UDolbyIOLoadTestClient::OnInitialized);
+	Subsystem->OnConnectedNative.AddUObject(this, &UDolbyIOLoadTestClient::OnConnected);
+	Subsystem->OnMessageReceivedNative.AddUObject(this, &UDolbyIOLoadTestClient::OnMessageReceived);
+	Subsystem->SetToken("");
+}
+
+void UDolbyIOLoadTestClient::Shutdown()
+{
+	// Deinitializing the subsystem stops its local backend
+	UWorld* World = GameInstance->GetWorld();
+	GameInstance->Shutdown();
+	if (World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+	Subsystem = nullptr;
+}
+
+void UDolbyIOLoadTestClient::OnInitialized()
+{
+	Subsystem->Connect("load-test", UserName, "", "", EDolbyIOConnectionMode::Active,
+	                   EDolbyIOSpatialAudioStyle::Individual);
+}
+
+void UDolbyIOLoadTestClient::OnConnected(const FString& LocalParticipantID, const FString& ConferenceID)
+{
+	bIsConnected = true;
+}
+
+void UDolbyIOLoadTestClient::OnMessageReceived(const FString& Message, const FDolbyIOParticipantInfo& ParticipantInfo)
+{
+	FVector Location;
+	double SentTime;
+	if (DolbyIO::FLocalBackend::ParsePositionMessage(Message, Location, SentTime))
+	{
+		DispatchLatencyMs.Add((FPlatformTime::Seconds() - SentTime) * 1000.0);
+		Subsystem->SetRemotePlayerLocation(ParticipantInfo.UserID, Location);
+	}
+}
+
+namespace DolbyIO
+{
+	namespace
+	{
+		// How often the game thread runs its queued tasks, similar to a game running at 60 fps
+		constexpr float GameThreadTickSeconds = 1.f / 60;
+		constexpr double ConnectTimeoutSeconds = 30.0;
+
+		struct FLoadTestSettings
+		{
+			int Clients = 4;
+			int Participants = 50;
+			int VideoParticipants = 4;
+			int PositionIntervalMs = 100;
+			float Seconds = 30.f;
+			bool bNullTexture = false;
+		};
+
+		struct FLoadTestResult
+		{
+			double CpuPct = 0;
+			int CpuSamples = 0;
+			double GameThreadMs = 0;
+			int GameThreadTicks = 0;
+			uint64 UsedPhysicalBefore = 0;
+			uint64 UsedPhysicalAfter = 0;
+			TArray<double> DispatchLatencyMs;
+			uint64 UploadedFrames = 0;
+			uint64 UploadedBytes = 0;
+			double Seconds = 0;
+		};
+
+		void SetConsoleVariable(const TCHAR* Name, int32 Value)
+		{
+			if (IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(Name))
+			{
+				Variable->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		double GetPercentile(TArray<double> Values, double Percentile)
+		{
+			if (!Values.Num())
+			{
+				return 0;
+			}
+			Values.Sort();
+			return Values[FMath::Min(Values.Num() - 1, FMath::FloorToInt(Values.Num() * Percentile))];
+		}
+
+		double GetAverage(const TArray<double>& Values)
+		{
+			double Sum = 0;
+			for (double Value : Values)
+			{
+				Sum += Value;
+			}
+			return Values.Num() ? Sum / Values.Num() : 0.0;
+		}
+
+		// Runs the tasks the clients' handlers posted to the game thread and broadcasts the events they queued, like
+		// the engine loop would, returns the time it took in milliseconds
+		double TickGameThread()
+		{
+			const double TickStart = FPlatformTime::Seconds();
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+#if ENGINE_MAJOR_VERSION == 5
+			FTSTicker::GetCoreTicker().Tick(GameThreadTickSeconds);
+#else
+			FTicker::GetCoreTicker().Tick(GameThreadTickSeconds);
+#endif
+			const double TickMs = (FPlatformTime::Seconds() - TickStart) * 1000.0;
+			FPlatformProcess::Sleep(FMath::Max(GameThreadTickSeconds - static_cast<float>(TickMs / 1000.0), 0.f));
+			return TickMs;
+		}
+
+		FLoadTestResult Run(const FLoadTestSettings& Settings)
+		{
+			SetConsoleVariable(TEXT("DolbyIO.LocalBackend"), 1);
+			SetConsoleVariable(TEXT("DolbyIO.LocalBackend.Participants"), Settings.Participants);
+			SetConsoleVariable(TEXT("DolbyIO.LocalBackend.VideoParticipants"), Settings.VideoParticipants);
+			SetConsoleVariable(TEXT("DolbyIO.LocalBackend.PositionIntervalMs"), Settings.PositionIntervalMs);
+			SetConsoleVariable(TEXT("DolbyIO.Video.NullTexture"), Settings.bNullTexture);
+
+			FLoadTestResult Result;
+			Result.UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+			TArray<UDolbyIOLoadTestClient*> Clients;
+			for (int i = 0; i < Settings.Clients; ++i)
+			{
+				UGameInstance* GameInstance = NewObject<UGameInstance>(GEngine);
+				GameInstance->InitializeStandalone();
+				UDolbyIOLoadTestClient* Client = NewObject<UDolbyIOLoadTestClient>();
+				Client->AddToRoot();
+				Client->Start(*GameInstance, FString::Printf(TEXT("Load test client %d"), i));
+				Clients.Add(Client);
+			}
+
+			const double ConnectStart = FPlatformTime::Seconds();
+			while (Clients.ContainsByPredicate([](UDolbyIOLoadTestClient* Client) { return !Client->IsConnected(); }))
+			{
+				if (FPlatformTime::Seconds() - ConnectStart > ConnectTimeoutSeconds)
+				{
+					DLB_UE_LOG_BASE(Warning, "Not all clients connected after %.0f s", ConnectTimeoutSeconds);
+					break;
+				}
+				TickGameThread();
+			}
+
+			// Only measure the steady state, once participants and video tracks have been added
+			for (int i = 0; i < 60; ++i)
+			{
+				TickGameThread();
+			}
+			for (UDolbyIOLoadTestClient* Client : Clients)
+			{
+				Client->DispatchLatencyMs.Empty();
+			}
+			const FVideoTexture::FUploadCounters& UploadCounters = FVideoTexture::GetTotalUploadCounters();
+			const uint64 UploadedFramesBefore = UploadCounters.Frames;
+			const uint64 UploadedBytesBefore = UploadCounters.Bytes;
+
+			const double Start = FPlatformTime::Seconds();
+			while (FPlatformTime::Seconds() - Start < Settings.Seconds)
+			{
+				Result.GameThreadMs += TickGameThread();
+				++Result.GameThreadTicks;
+				Result.CpuPct += FPlatformTime::GetCPUTime().CPUTimePct;
+				++Result.CpuSamples;
+			}
+			Result.Seconds = FPlatformTime::Seconds() - Start;
+			Result.UsedPhysicalAfter = FPlatformMemory::GetStats().UsedPhysical;
+			Result.UploadedFrames = UploadCounters.Frames - UploadedFramesBefore;
+			Result.UploadedBytes = UploadCounters.Bytes - UploadedBytesBefore;
+
+			for (UDolbyIOLoadTestClient* Client : Clients)
+			{
+				Result.DispatchLatencyMs.Append(Client->DispatchLatencyMs);
+				Client->Shutdown();
+				Client->RemoveFromRoot();
+			}
+
+			// Let the textures go back to the pool
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FlushRenderingCommands();
+			return Result;
+		}
+
+		FString ToCsvRow(const FLoadTestSettings& Settings, const FLoadTestResult& Result)
+		{
+			// Process wide figures divided by the number of clients, so they include the local backend, frame
+			// synthesis and the rendering thread
+			const double UsedPhysicalMB =
+			    (static_cast<double>(Result.UsedPhysicalAfter) - Result.UsedPhysicalBefore) / (1024.0 * 1024.0);
+			return FString::Printf(
+			    TEXT("%d,%d,%d,%d,%s,%.2f,%.2f,%.3f,%.3f,%.3f,%.1f,%.2f"), Settings.Clients, Settings.Participants,
+			    Settings.VideoParticipants, Settings.PositionIntervalMs,
+			    Settings.bNullTexture ? TEXT("true") : TEXT("false"),
+			    Result.CpuSamples ? Result.CpuPct / Result.CpuSamples / Settings.Clients : 0.0,
+			    UsedPhysicalMB / Settings.Clients,
+			    Result.GameThreadTicks ? Result.GameThreadMs / Result.GameThreadTicks : 0.0,
+			    GetAverage(Result.DispatchLatencyMs), GetPercentile(Result.DispatchLatencyMs, 0.99),
+			    Result.UploadedFrames / Result.Seconds, Result.UploadedBytes / Result.Seconds / (1024.0 * 1024.0));
+		}
+
+		const TCHAR* CsvHeader = TEXT("Clients,Participants,VideoParticipants,PositionIntervalMs,NullTexture,"
+		                              "ProcessCpuPctPerClient,ProcessMemoryMBPerClient,GameThreadPerTickMs,"
+		                              "DispatchLatencyAvgMs,DispatchLatencyP99Ms,UploadedFps,UploadedMBps");
+	}
+}
+
+UDolbyIOLoadTestCommandlet::UDolbyIOLoadTestCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UDolbyIOLoadTestCommandlet::Main(const FString& Params)
+{
+	using namespace DolbyIO;
+
+	FLoadTestSettings Settings;
+	FParse::Value(*Params, TEXT("Clients="), Settings.Clients);
+	FParse::Value(*Params, TEXT("Participants="), Settings.Participants);
+	FParse::Value(*Params, TEXT("VideoParticipants="), Settings.VideoParticipants);
+	FParse::Value(*Params, TEXT("PositionIntervalMs="), Settings.PositionIntervalMs);
+	FParse::Value(*Params, TEXT("Seconds="), Settings.Seconds);
+	Settings.bNullTexture = FParse::Param(*Params, TEXT("NullTexture")) || !FApp::CanEverRender();
+	FString CsvPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DolbyIO"), TEXT("LoadTest.csv"));
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+	if (Settings.Clients <= 0 || Settings.Participants < 0 || Settings.VideoParticipants < 0 ||
+	    Settings.PositionIntervalMs < 0 || Settings.Seconds <= 0)
+	{
+		DLB_UE_LOG_BASE(Error, "Usage: -run=DolbyIOLoadTest [-Clients=4] [-Participants=50] [-VideoParticipants=4] "
+		                       "[-PositionIntervalMs=100] [-Seconds=30] [-NullTexture] [-Csv=path]");
+		return 1;
+	}
+
+	DLB_UE_LOG_BASE(Display, "Running %d clients with %d participants, %d with video, for %.1f s", Settings.Clients,
+	                Settings.Participants, Settings.VideoParticipants, Settings.Seconds);
+	// The subsystem logs every event, which would dominate the measurements
+	const ELogVerbosity::Type Verbosity = LogDolbyIO.GetVerbosity();
+	LogDolbyIO.SetVerbosity(ELogVerbosity::Display);
+	const FString Row = ToCsvRow(Settings, Run(Settings));
+	LogDolbyIO.SetVerbosity(Verbosity);
+	DLB_UE_LOG("%s", *Row);
+
+	// Append to an existing file so that results of several plugin versions can be compared side by side
+	TArray<FString> Rows;
+	if (!IFileManager::Get().FileExists(*CsvPath))
+	{
+		Rows.Add(CsvHeader);
+	}
+	Rows.Add(Row);
+	if (!FFileHelper::SaveStringArrayToFile(Rows, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect,
+	                                        &IFileManager::Get(), FILEWRITE_Append))
+	{
+		DLB_UE_LOG_BASE(Error, "Could not write %s", *CsvPath);
+		return 1;
+	}
+	DLB_UE_LOG("Results written to %s", *CsvPath);
+	return 0;
+}
@@ -0,0 +1,66 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+#include "DolbyIOTypes.h"
+
+#include "DolbyIOLoadTestCommandlet.generated.h"
+
+class UDolbyIOSubsystem;
+class UGameInstance;
+
+/** One game client of the load test. Applies the locations remote participants publish, like a game would. */
+UCLASS()
+class UDolbyIOLoadTestClient : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	void Start(UGameInstance& InGameInstance, const FString& InUserName);
+	void Shutdown();
+
+	bool IsConnected() const
+	{
+		return bIsConnected;
+	}
+
+	// Time between a location being sent by the local backend and being handled on the game thread
+	TArray<double> DispatchLatencyMs;
+
+private:
+	void OnInitialized();
+	void OnConnected(const FString& LocalParticipantID, const FString& ConferenceID);
+	void OnMessageReceived(const FString& Message, const FDolbyIOParticipantInfo& ParticipantInfo);
+
+	UPROPERTY()
+	UGameInstance* GameInstance;
+	UPROPERTY()
+	UDolbyIOSubsystem* Subsystem;
+
+	FString UserName;
+	bool bIsConnected = false;
+};
+
+/** Runs many game clients against the local backend in one process and reports what they cost as CSV. Every client
+ * has its own game instance and subsystem, and joins a local conference whose participants publish video, audio
+ * levels and locations. Video textures are not uploaded when running with -nullrhi or -NullTexture.
+ *
+ * UnrealEditor-Cmd <Project> -run=DolbyIOLoadTest [-nullrhi] [-Clients=4] [-Participants=50] [-VideoParticipants=4]
+ * [-PositionIntervalMs=100] [-Seconds=30] [-NullTexture] [-Csv=<path>]
+ *
+ * Video resolution, frame rate and format are taken from the DolbyIO.LocalBackend.* console variables.
+ *
+ * CPU and memory are measured for the whole process and averaged over the clients, so they also include the local
+ * backend, frame synthesis and the rendering thread. They compare plugin versions, they are not the cost of one game.
+ */
+UCLASS()
+class UDolbyIOLoadTestCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UDolbyIOLoadTestCommandlet();
+
+	int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,502 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOLocalBackend.h"
+
+#include "DolbyIOEventTrace.h"
+#include "Utils/DolbyIOBroadcastEvent.h"
+#include "Utils/DolbyIOConversions.h"
+#include "Utils/DolbyIOLogging.h"
+#include "Video/DolbyIOSyntheticVideoFrame.h"
+
+#include "HAL/Event.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Guid.h"
+
+namespace DolbyIO
+{
+	using namespace dolbyio::comms;
+
+	namespace
+	{
+		TAutoConsoleVariable<bool> CVarLocalBackend{
+		    TEXT("DolbyIO.LocalBackend"), false,
+		    TEXT("Whether Set Token starts a local stand-in for the Dolby.io backend instead of connecting to it, "
+		         "which allows running the plugin without network access, e.g. in load tests. Read when the token is "
+		         "set for the first time.")};
+
+		TAutoConsoleVariable<int32> CVarParticipants{TEXT("DolbyIO.LocalBackend.Participants"), 8,
+		                                             TEXT("Number of remote participants in local conferences.")};
+
+		TAutoConsoleVariable<int32> CVarVideoParticipants{
+		    TEXT("DolbyIO.LocalBackend.VideoParticipants"), 4,
+		    TEXT("Number of remote participants publishing a video track in local conferences.")};
+
+		TAutoConsoleVariable<int32> CVarVideoWidth{TEXT("DolbyIO.LocalBackend.VideoWidth"), 1280,
+		                                           TEXT("Width of the video frames of local conferences.")};
+
+		TAutoConsoleVariable<int32> CVarVideoHeight{TEXT("DolbyIO.LocalBackend.VideoHeight"), 720,
+		                                            TEXT("Height of the video frames of local conferences.")};
+
+		TAutoConsoleVariable<int32> CVarVideoFps{TEXT("DolbyIO.LocalBackend.VideoFps"), 30,
+		                                         TEXT("Frame rate of the video tracks of local conferences.")};
+
+		TAutoConsoleVariable<int32> CVarVideoFormat{TEXT("DolbyIO.LocalBackend.VideoFormat"), 0,
+		                                            TEXT("Format of the video frames of local conferences.\n"
+		                                                 "0: I420 (default)\n"
+		                                                 "1: NV12\n"
+		                                                 "2: ARGB")};
+
+		TAutoConsoleVariable<int32> CVarSessionLatencyMs{
+		    TEXT("DolbyIO.LocalBackend.SessionLatencyMs"), 50,
+		    TEXT("Time in milliseconds the local backend takes to initialize and to open a session.")};
+
+		TAutoConsoleVariable<int32> CVarConferenceLatencyMs{
+		    TEXT("DolbyIO.LocalBackend.ConferenceLatencyMs"), 150,
+		    TEXT("Time in milliseconds the local backend takes to join or leave a conference.")};
+
+		TAutoConsoleVariable<int32> CVarMessageLatencyMs{
+		    TEXT("DolbyIO.LocalBackend.MessageLatencyMs"), 30,
+		    TEXT("Time in milliseconds after which remote participants of local conferences echo sent messages.")};
+
+		TAutoConsoleVariable<int32> CVarAudioLevelsIntervalMs{
+		    TEXT("DolbyIO.LocalBackend.AudioLevelsIntervalMs"), 500,
+		    TEXT("Interval in milliseconds between audio levels events of local conferences.")};
+
+		TAutoConsoleVariable<int32> CVarChurnIntervalMs{
+		    TEXT("DolbyIO.LocalBackend.ChurnIntervalMs"), 0,
+		    TEXT("Interval in milliseconds after which a remote participant of local conferences leaves or comes "
+		         "back. 0 disables churn.")};
+
+		TAutoConsoleVariable<int32> CVarPositionIntervalMs{
+		    TEXT("DolbyIO.LocalBackend.PositionIntervalMs"), 0,
+		    TEXT("Interval in milliseconds between the position messages sent by every remote participant of local "
+		         "conferences. 0 disables position messages.")};
+
+		constexpr int NumFrameVariants = 4;
+		constexpr const TCHAR* PositionMessagePrefix = TEXT("DolbyIO.LocalBackend.Position");
+
+		participant_info ToParticipantInfo(const FString& ID, const FString& Name, participant_status Status)
+		{
+			participant_info Ret{};
+			Ret.user_id = ToStdString(ID);
+			Ret.info.name = ToStdString(Name);
+			Ret.info.external_id = ToStdString(Name);
+			Ret.status = Status;
+			Ret.is_sending_audio = true;
+			Ret.audible_locally = true;
+			return Ret;
+		}
+
+		video_track ToVideoTrack(const FString& ParticipantID, const FString& VideoTrackID)
+		{
+			video_track Ret{};
+			Ret.sdp_track_id = ToStdString(VideoTrackID);
+			Ret.peer_id = ToStdString(ParticipantID);
+			Ret.is_screenshare = false;
+			return Ret;
+		}
+	}
+
+	FLocalBackend::FSettings FLocalBackend::FSettings::FromConsoleVariables()
+	{
+		FSettings Ret;
+		Ret.NumParticipants = FMath::Max(CVarParticipants.GetValueOnAnyThread(), 0);
+		Ret.NumVideoParticipants = FMath::Clamp(CVarVideoParticipants.GetValueOnAnyThread(), 0, Ret.NumParticipants);
+		Ret.VideoWidth = FMath::Max(CVarVideoWidth.GetValueOnAnyThread(), 2);
+		Ret.VideoHeight = FMath::Max(CVarVideoHeight.GetValueOnAnyThread(), 2);
+		Ret.VideoFps = FMath::Max(CVarVideoFps.GetValueOnAnyThread(), 1);
+		Ret.VideoFormat = CVarVideoFormat.GetValueOnAnyThread();
+		Ret.SessionLatency = CVarSessionLatencyMs.GetValueOnAnyThread() / 1000.0;
+		Ret.ConferenceLatency = CVarConferenceLatencyMs.GetValueOnAnyThread() / 1000.0;
+		Ret.MessageLatency = CVarMessageLatencyMs.GetValueOnAnyThread() / 1000.0;
+		Ret.AudioLevelsInterval = CVarAudioLevelsIntervalMs.GetValueOnAnyThread() / 1000.0;
+		Ret.ChurnInterval = CVarChurnIntervalMs.GetValueOnAnyThread() / 1000.0;
+		Ret.PositionInterval = CVarPositionIntervalMs.GetValueOnAnyThread() / 1000.0;
+		return Ret;
+	}
+
+	bool FLocalBackend::IsEnabled()
+	{
+		return CVarLocalBackend.GetValueOnAnyThread();
+	}
+
+	bool FLocalBackend::ParsePositionMessage(const FString& Message, FVector& OutLocation, double& OutSentTime)
+	{
+		if (!Message.StartsWith(PositionMessagePrefix))
+		{
+			return false;
+		}
+
+		TArray<FString> Values;
+		Message.RightChop(FCString::Strlen(PositionMessagePrefix)).ParseIntoArrayWS(Values);
+		if (Values.Num() != 4)
+		{
+			return false;
+		}
+		OutLocation = {FCString::Atof(*Values[0]), FCString::Atof(*Values[1]), FCString::Atof(*Values[2])};
+		OutSentTime = FCString::Atod(*Values[3]);
+		return true;
+	}
+
+	FLocalBackend::FLocalBackend(UDolbyIOSubsystem& Subsystem, const FSettings& Settings)
+	    : Subsystem(Subsystem), Settings(Settings), WakeUp(FPlatformProcess::GetSynchEventFromPool())
+	{
+		Thread = FRunnableThread::Create(this, TEXT("DolbyIOLocalBackend"));
+	}
+
+	FLocalBackend::~FLocalBackend()
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+		FPlatformProcess::ReturnSynchEventToPool(WakeUp);
+	}
+
+	void FLocalBackend::Initialize()
+	{
+		Schedule(Settings.SessionLatency,
+		         [this]
+		         {
+			         DLB_UE_LOG("Initialized local backend: %d participants, %d with %dx%d video at %d fps",
+			                    Settings.NumParticipants, Settings.NumVideoParticipants, Settings.VideoWidth,
+			                    Settings.VideoHeight, Settings.VideoFps);
+			         Subsystem.BroadcastEvent(Subsystem.OnInitialized, Subsystem.OnInitializedNative);
+		         });
+	}
+
+	void FLocalBackend::Connect()
+	{
+		Schedule(Settings.SessionLatency,
+		         [this]
+		         {
+			         Subsystem.LocalParticipantID = FGuid::NewGuid().ToString(EGuidFormats::DigitsWithHyphens);
+			         Schedule(Settings.ConferenceLatency,
+			                  [this]
+			                  {
+				                  Subsystem.ConferenceID = FGuid::NewGuid().ToString(EGuidFormats::DigitsWithHyphens);
+				                  DLB_UE_LOG("Connected to local conference ID %s with user ID %s",
+				                             *Subsystem.ConferenceID, *Subsystem.LocalParticipantID);
+				                  conference_status_updated StatusUpdated{};
+				                  StatusUpdated.status = conference_status::joined;
+				                  Subsystem.HandleAndRecord(StatusUpdated);
+				                  AddParticipants();
+			                  });
+		         });
+	}
+
+	void FLocalBackend::Disconnect()
+	{
+		Schedule(Settings.ConferenceLatency,
+		         [this]
+		         {
+			         ++ConferenceGeneration;
+			         for (FParticipant& Participant : Participants)
+			         {
+				         if (Participant.bIsConnected)
+				         {
+					         DisconnectParticipant(Participant);
+				         }
+			         }
+			         Participants.Empty();
+			         ActiveSpeakers.Empty();
+			         {
+				         FScopeLock Lock{&SpatialPositionsLock};
+				         SpatialPositions.Empty();
+			         }
+			         conference_status_updated StatusUpdated{};
+			         StatusUpdated.status = conference_status::left;
+			         Subsystem.HandleAndRecord(StatusUpdated);
+		         });
+	}
+
+	void FLocalBackend::SendMessage(const FString& Message, const TArray<FString>& ParticipantIDs)
+	{
+		Schedule(Settings.MessageLatency,
+		         [this, Message, ParticipantIDs]
+		         {
+			         // Every recipient sends the message back
+			         for (const FParticipant& Participant : Participants)
+			         {
+				         if (Participant.bIsConnected &&
+				             (!ParticipantIDs.Num() || ParticipantIDs.Contains(Participant.ID)))
+				         {
+					         conference_message_received Event{};
+					         Event.conference_id = ToStdString(Subsystem.ConferenceID);
+					         Event.user_id = ToStdString(Participant.ID);
+					         Event.message = ToStdString(Message);
+					         Subsystem.HandleAndRecord(Event);
+				         }
+			         }
+		         });
+	}
+
+	void FLocalBackend::SetVideoSink(const FString& VideoTrackID, std::shared_ptr<video_sink> Sink)
+	{
+		FScopeLock Lock{&VideoSinksLock};
+		VideoSinks.Emplace(VideoTrackID, MoveTemp(Sink));
+	}
+
+	void FLocalBackend::SetSpatialPosition(const FString& ParticipantID, const FVector& Location)
+	{
+		FScopeLock Lock{&SpatialPositionsLock};
+		SpatialPositions.Emplace(ParticipantID, Location);
+	}
+
+	uint32 FLocalBackend::Run()
+	{
+		while (!bIsStopping)
+		{
+			FScheduledEvent Event{};
+			uint32 WaitMs = 100;
+			{
+				FScopeLock Lock{&EventsLock};
+				if (Events.Num())
+				{
+					const double Now = FPlatformTime::Seconds();
+					if (Events.HeapTop().Time <= Now)
+					{
+						Events.HeapPop(Event);
+					}
+					else
+					{
+						WaitMs = FMath::Min(WaitMs, static_cast<uint32>((Events.HeapTop().Time - Now) * 1000.0) + 1);
+					}
+				}
+			}
+
+			if (Event.Action)
+			{
+				Event.Action();
+			}
+			else
+			{
+				WakeUp->Wait(WaitMs);
+			}
+		}
+		return 0;
+	}
+
+	void FLocalBackend::Stop()
+	{
+		bIsStopping = true;
+		WakeUp->Trigger();
+	}
+
+	void FLocalBackend::Schedule(double Delay, TFunction<void()> Action)
+	{
+		{
+			FScopeLock Lock{&EventsLock};
+			Events.HeapPush(FScheduledEvent{FPlatformTime::Seconds() + Delay, MoveTemp(Action)});
+		}
+		WakeUp->Trigger();
+	}
+
+	void FLocalBackend::ScheduleRepeating(double Interval, TFunction<void()> Action)
+	{
+		Schedule(Interval,
+		         [this, Interval, Action = MoveTemp(Action), Generation = ConferenceGeneration.load()]() mutable
+		         {
+			         if (Generation == ConferenceGeneration)
+			         {
+				         Action();
+				         ScheduleRepeating(Interval, MoveTemp(Action));
+			         }
+		         });
+	}
+
+	void FLocalBackend::AddParticipants()
+	{
+		Frames.Empty();
+		if (Settings.NumVideoParticipants)
+		{
+			const ESyntheticVideoFormat Format = static_cast<ESyntheticVideoFormat>(
+			    FMath::Clamp(Settings.VideoFormat, 0, static_cast<int>(ESyntheticVideoFormat::Argb)));
+			for (int i = 0; i < NumFrameVariants; ++i)
+			{
+				Frames.Add(
+				    std::make_shared<FSyntheticVideoFrame>(Format, Settings.VideoWidth, Settings.VideoHeight, i));
+			}
+		}
+
+		for (int i = 0; i < Settings.NumParticipants; ++i)
+		{
+			FParticipant& Participant = Participants.Add_GetRef(
+			    {FString::Printf(TEXT("local-participant-%d"), i), FString::Printf(TEXT("Participant %d"), i),
+			     i < Settings.NumVideoParticipants ? FString::Printf(TEXT("local-video-track-%d"), i) : FString{},
+			     false});
+			ConnectParticipant(Participant);
+		}
+
+		if (Settings.AudioLevelsInterval > 0)
+		{
+			ScheduleRepeating(Settings.AudioLevelsInterval, [this] { DeliverAudioLevels(); });
+		}
+		if (Settings.NumVideoParticipants)
+		{
+			ScheduleRepeating(1.0 / Settings.VideoFps, [this] { DeliverVideoFrames(); });
+		}
+		if (Settings.ChurnInterval > 0)
+		{
+			ScheduleRepeating(Settings.ChurnInterval, [this] { ChurnParticipant(); });
+		}
+		if (Settings.PositionInterval > 0)
+		{
+			ScheduleRepeating(Settings.PositionInterval, [this] { DeliverPositions(); });
+		}
+	}
+
+	void FLocalBackend::ConnectParticipant(FParticipant& Participant)
+	{
+		Participant.bIsConnected = true;
+		remote_participant_added ParticipantAdded{};
+		ParticipantAdded.participant = ToParticipantInfo(Participant.ID, Participant.Name, participant_status::on_air);
+		Subsystem.HandleAndRecord(ParticipantAdded);
+
+		if (Participant.VideoTrackID.IsEmpty())
+		{
+			return;
+		}
+
+		remote_video_track_added TrackAdded{};
+		TrackAdded.track = ToVideoTrack(Participant.ID, Participant.VideoTrackID);
+		Subsystem.HandleAndRecord(TrackAdded);
+
+		utils::vfs_event VfsEvent{};
+		VfsEvent.new_enabled.emplace(ToStdString(Participant.ID),
+		                             ToSdkTrackMapValue(ToStdString(Participant.VideoTrackID)));
+		Subsystem.HandleAndRecord(VfsEvent);
+	}
+
+	void FLocalBackend::DisconnectParticipant(FParticipant& Participant)
+	{
+		Participant.bIsConnected = false;
+		if (!Participant.VideoTrackID.IsEmpty())
+		{
+			{
+				FScopeLock Lock{&VideoSinksLock};
+				VideoSinks.Remove(Participant.VideoTrackID);
+			}
+
+			utils::vfs_event VfsEvent{};
+			VfsEvent.new_disabled.emplace(ToStdString(Participant.ID),
+			                              ToSdkTrackMapValue(ToStdString(Participant.VideoTrackID)));
+			Subsystem.HandleAndRecord(VfsEvent);
+
+			remote_video_track_removed TrackRemoved{};
+			TrackRemoved.track = ToVideoTrack(Participant.ID, Participant.VideoTrackID);
+			Subsystem.HandleAndRecord(TrackRemoved);
+		}
+
+		remote_participant_updated ParticipantUpdated{};
+		ParticipantUpdated.participant = ToParticipantInfo(Participant.ID, Participant.Name, participant_status::left);
+		Subsystem.HandleAndRecord(ParticipantUpdated);
+	}
+
+	void FLocalBackend::ChurnParticipant()
+	{
+		if (!Participants.Num())
+		{
+			return;
+		}
+
+		FParticipant& Participant = Participants[Random.RandHelper(Participants.Num())];
+		if (Participant.bIsConnected)
+		{
+			DisconnectParticipant(Participant);
+			return;
+		}
+
+		// Participants coming back get a new video track like they do in real conferences
+		if (!Participant.VideoTrackID.IsEmpty())
+		{
+			Participant.VideoTrackID = FGuid::NewGuid().ToString(EGuidFormats::DigitsWithHyphens);
+		}
+		Participant.bIsConnected = true;
+		remote_participant_updated ParticipantUpdated{};
+		ParticipantUpdated.participant =
+		    ToParticipantInfo(Participant.ID, Participant.Name, participant_status::on_air);
+		Subsystem.HandleAndRecord(ParticipantUpdated);
+
+		if (!Participant.VideoTrackID.IsEmpty())
+		{
+			remote_video_track_added TrackAdded{};
+			TrackAdded.track = ToVideoTrack(Participant.ID, Participant.VideoTrackID);
+			Subsystem.HandleAndRecord(TrackAdded);
+
+			utils::vfs_event VfsEvent{};
+			VfsEvent.new_enabled.emplace(ToStdString(Participant.ID),
+			                             ToSdkTrackMapValue(ToStdString(Participant.VideoTrackID)));
+			Subsystem.HandleAndRecord(VfsEvent);
+		}
+	}
+
+	void FLocalBackend::DeliverAudioLevels()
+	{
+		// About a quarter of the participants speak at any time
+		audio_levels Event{};
+		TArray<FString> Speakers;
+		for (const FParticipant& Participant : Participants)
+		{
+			if (Participant.bIsConnected && Random.FRand() < 0.25f)
+			{
+				audio_level Level{};
+				Level.participant_id = ToStdString(Participant.ID);
+				Level.level = Random.FRandRange(0.05f, 1.f);
+				Event.levels.push_back(MoveTemp(Level));
+				Speakers.Add(Participant.ID);
+			}
+		}
+		Subsystem.HandleAndRecord(Event);
+
+		if (Speakers != ActiveSpeakers)
+		{
+			ActiveSpeakers = MoveTemp(Speakers);
+			active_speaker_changed SpeakersChanged{};
+			for (const FString& Speaker : ActiveSpeakers)
+			{
+				SpeakersChanged.active_speakers.push_back(ToStdString(Speaker));
+			}
+			Subsystem.HandleAndRecord(SpeakersChanged);
+		}
+	}
+
+	void FLocalBackend::DeliverVideoFrames()
+	{
+		FSyntheticVideoFrame& Frame = *Frames[FrameIndex % NumFrameVariants];
+		Frame.SetTimestamp(FrameIndex * 1000000ll / Settings.VideoFps);
+		++FrameIndex;
+
+		FScopeLock Lock{&VideoSinksLock};
+		for (const auto& Sink : VideoSinks)
+		{
+			Sink.Value->handle_frame(Frame);
+		}
+	}
+
+	void FLocalBackend::DeliverPositions()
+	{
+		// Participants walk around a circle of their own, all at the same pace
+		const double Now = FPlatformTime::Seconds();
+		for (int i = 0; i < Participants.Num(); ++i)
+		{
+			const FParticipant& Participant = Participants[i];
+			if (!Participant.bIsConnected)
+			{
+				continue;
+			}
+
+			const double Angle = Now * 0.5 + i;
+			const double Radius = 500.0 + 50.0 * (i % 10);
+			conference_message_received Event{};
+			Event.conference_id = ToStdString(Subsystem.ConferenceID);
+			Event.user_id = ToStdString(Participant.ID);
+			Event.message = ToStdString(FString::Printf(TEXT("%s %.1f %.1f %.1f %.6f"), PositionMessagePrefix,
+			                                            Radius * FMath::Cos(Angle), Radius * FMath::Sin(Angle), 0.0,
+			                                            Now));
+			Subsystem.HandleAndRecord(Event);
+		}
+	}
+}
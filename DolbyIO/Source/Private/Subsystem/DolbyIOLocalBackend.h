@@ -0,0 +1,126 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "Utils/DolbyIOCppSdk.h"
+
+#include "Containers/Array.h"
+#include "Containers/Map.h"
+#include "Containers/UnrealString.h"
+#include "HAL/CriticalSection.h"
+#include "Math/Vector.h"
+#include "HAL/Runnable.h"
+#include "Math/RandomStream.h"
+#include "Templates/Function.h"
+
+#include <atomic>
+#include <memory>
+
+class FEvent;
+class FRunnableThread;
+class UDolbyIOSubsystem;
+
+namespace DolbyIO
+{
+	class FSyntheticVideoFrame;
+
+	// A stand-in for the Dolby.io backend which lets the subsystem run without network access, e.g. in load tests. It
+	// simulates the session, the conference and a number of remote participants publishing video, audio levels and
+	// messages, all configured with DolbyIO.LocalBackend.* console variables. Events are delivered to the subsystem's
+	// handlers on the backend's own thread, like the SDK does. Remote participants can also publish their location as
+	// conference messages, the way games usually share player positions, which ParsePositionMessage decodes.
+	class FLocalBackend final : public FRunnable
+	{
+	public:
+		struct FSettings
+		{
+			int NumParticipants;
+			int NumVideoParticipants;
+			int VideoWidth;
+			int VideoHeight;
+			int VideoFps;
+			int VideoFormat;
+			double SessionLatency;
+			double ConferenceLatency;
+			double MessageLatency;
+			double AudioLevelsInterval;
+			double ChurnInterval;
+			double PositionInterval;
+
+			static FSettings FromConsoleVariables();
+		};
+
+		static bool IsEnabled();
+		// OutSentTime is the FPlatformTime::Seconds at which the backend sent the message.
+		static bool ParsePositionMessage(const FString& Message, FVector& OutLocation, double& OutSentTime);
+
+		FLocalBackend(UDolbyIOSubsystem& Subsystem, const FSettings& Settings = FSettings::FromConsoleVariables());
+		~FLocalBackend();
+
+		void Initialize();
+		void Connect();
+		void Disconnect();
+		void SendMessage(const FString& Message, const TArray<FString>& ParticipantIDs);
+		void SetVideoSink(const FString& VideoTrackID, std::shared_ptr<dolbyio::comms::video_sink> Sink);
+		void SetSpatialPosition(const FString& ParticipantID, const FVector& Location);
+
+	private:
+		struct FScheduledEvent
+		{
+			double Time;
+			TFunction<void()> Action;
+
+			bool operator<(const FScheduledEvent& Other) const
+			{
+				return Time < Other.Time;
+			}
+		};
+
+		struct FParticipant
+		{
+			FString ID;
+			FString Name;
+			FString VideoTrackID;
+			bool bIsConnected;
+		};
+
+		uint32 Run() override;
+		void Stop() override;
+
+		void Schedule(double Delay, TFunction<void()> Action);
+		// Calls Action every Interval seconds until the conference is left
+		void ScheduleRepeating(double Interval, TFunction<void()> Action);
+
+		void AddParticipants();
+		void ConnectParticipant(FParticipant& Participant);
+		void DisconnectParticipant(FParticipant& Participant);
+		void ChurnParticipant();
+		void DeliverAudioLevels();
+		void DeliverVideoFrames();
+		void DeliverPositions();
+
+		UDolbyIOSubsystem& Subsystem;
+		const FSettings Settings;
+
+		TArray<FScheduledEvent> Events;
+		FCriticalSection EventsLock;
+		FEvent* WakeUp;
+		FRunnableThread* Thread;
+		std::atomic<bool> bIsStopping{false};
+		// Incremented whenever the conference is left to stop the repeating events of the previous one
+		std::atomic<uint32> ConferenceGeneration{0};
+
+		// Only used on the backend thread
+		TArray<FParticipant> Participants;
+		TArray<std::shared_ptr<FSyntheticVideoFrame>> Frames;
+		TArray<FString> ActiveSpeakers;
+		FRandomStream Random{0};
+		uint32 FrameIndex = 0;
+
+		TMap<FString, std::shared_ptr<dolbyio::comms::video_sink>> VideoSinks;
+		FCriticalSection VideoSinksLock;
+
+		TMap<FString, FVector> SpatialPositions;
+		FCriticalSection SpatialPositionsLock;
+	};
+}
@@ -0,0 +1,67 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIO.h"
+
+#include "Utils/DolbyIOEventQueue.h"
+#include "Utils/DolbyIOMemory.h"
+#include "Utils/DolbyIOPerformance.h"
+#include "Video/DolbyIOVideoSink.h"
+#include "Video/DolbyIOVideoTexturePool.h"
+
+#include "HAL/PlatformTime.h"
+
+using namespace DolbyIO;
+
+namespace
+{
+	using FVideoSinks = TArray<std::shared_ptr<FVideoSink>>;
+}
+
+FDolbyIOPerformanceSnapshot UDolbyIOSubsystem::GetPerformanceSnapshot()
+{
+	FDolbyIOPerformanceSnapshot Snapshot;
+	UpdatePerformanceSnapshot(Snapshot);
+	return Snapshot;
+}
+
+// Neither locks nor allocates once the snapshot holds as many tracks as are published, so that C++ code can poll the
+// same snapshot every frame
+void UDolbyIOSubsystem::UpdatePerformanceSnapshot(FDolbyIOPerformanceSnapshot& Snapshot)
+{
+	const double Now = FPlatformTime::Seconds();
+	Snapshot.TextureMemoryBytes = 0;
+	if (const std::shared_ptr<const FVideoSinks> Sinks = std::atomic_load(&PublishedVideoSinks))
+	{
+		Snapshot.VideoTracks.SetNum(Sinks->Num(), false);
+		for (int32 i = 0; i < Sinks->Num(); ++i)
+		{
+			(*Sinks)[i]->GetPerformance(Now, Snapshot.VideoTracks[i]);
+			Snapshot.TextureMemoryBytes += Snapshot.VideoTracks[i].TextureMemoryBytes;
+		}
+	}
+	else
+	{
+		Snapshot.VideoTracks.Reset();
+	}
+	Snapshot.VideoMemoryBudgetBytes = VideoMemoryBudget;
+	Snapshot.PendingEvents = EventQueue->GetNumPending();
+	EventQueue->GetCoalescedEventCounters(Snapshot.CoalescedEvents);
+	Snapshot.PooledTextureMemoryBytes = FVideoTexturePool::Get().GetStats().PooledBytes;
+	Snapshot.SdkMemoryBytes = GetSdkMemoryCounters().GetBytes();
+
+	FPerformanceCounters& Counters = *PerformanceCounters;
+	Snapshot.SpatialUpdatesPerSecond = Counters.SpatialUpdateRate.Update(Counters.SpatialUpdates, Now);
+	Snapshot.MessagesSentPerSecond = Counters.MessageSendRate.Update(Counters.MessagesSent, Now);
+	Snapshot.MessagesReceivedPerSecond = Counters.MessageReceiveRate.Update(Counters.MessagesReceived, Now);
+}
+
+void UDolbyIOSubsystem::PublishVideoSinks()
+{
+	std::shared_ptr<FVideoSinks> Sinks = std::make_shared<FVideoSinks>();
+	Sinks->Reserve(VideoSinks.Num());
+	for (auto& Sink : VideoSinks)
+	{
+		Sinks->Add(Sink.Value);
+	}
+	std::atomic_store(&PublishedVideoSinks, std::shared_ptr<const FVideoSinks>{MoveTemp(Sinks)});
+}
@@ -6,6 +6,7 @@
 #include "Utils/DolbyIOConversions.h"
 #include "Utils/DolbyIOErrorHandler.h"
 #include "Utils/DolbyIOLogging.h"
+#include "Utils/DolbyIOTrace.h"
 #include "Video/DolbyIOVideoFrameHandler.h"
 
 using namespace dolbyio::comms;
@@ -30,7 +31,7 @@ void UDolbyIOSubsystem::GetScreenshareSources()
 		        {
 			        Ret.Add(ToFDolbyIOScreenshareSource(Source));
 		        }
-		        BroadcastEvent(OnScreenshareSourcesReceived, Ret);
+		        DLB_BROADCAST(OnScreenshareSourcesReceived, MoveTemp(Ret));
 	        })
 	    .on_error(DLB_ERROR_HANDLER(OnGetScreenshareSourcesError));
 }
@@ -40,6 +41,11 @@ void UDolbyIOSubsystem::StartScreenshare(const FDolbyIOScreenshareSource& Source
                                          EDolbyIOScreenshareMaxResolution MaxResolution,
                                          EDolbyIOScreenshareDownscaleQuality DownscaleQuality)
 {
+	if (!Sdk)
+	{
+		DLB_WARNING(OnStartScreenshareError, "Cannot start screenshare - not initialized");
+		return;
+	}
 	if (!IsConnectedAsActive())
 	{
 		DLB_WARNING(OnStartScreenshareError, "Cannot start screenshare - not connected as active user");
@@ -53,7 +59,7 @@ void UDolbyIOSubsystem::StartScreenshare(const FDolbyIOScreenshareSource& Source
 	Sdk->conference()
 	    .start_screen_share(SdkSource, LocalScreenshareFrameHandler,
 	                        ToSdkContentInfo(EncoderHint, MaxResolution, DownscaleQuality))
-	    .then([this] { BroadcastEvent(OnScreenshareStarted, LocalScreenshareTrackID); })
+	    .then([this] { DLB_BROADCAST(OnScreenshareStarted, LocalScreenshareTrackID); })
 	    .on_error(DLB_ERROR_HANDLER(OnStartScreenshareError));
 }
 
@@ -67,7 +73,7 @@ void UDolbyIOSubsystem::StopScreenshare()
 	DLB_UE_LOG("Stopping screenshare");
 	Sdk->conference()
 	    .stop_screen_share()
-	    .then([this] { BroadcastEvent(OnScreenshareStopped, LocalScreenshareTrackID); })
+	    .then([this] { DLB_BROADCAST(OnScreenshareStopped, LocalScreenshareTrackID); })
 	    .on_error(DLB_ERROR_HANDLER(OnStopScreenshareError));
 }
 
@@ -75,7 +81,7 @@ void UDolbyIOSubsystem::ChangeScreenshareParameters(EDolbyIOScreenshareEncoderHi
                                                     EDolbyIOScreenshareMaxResolution MaxResolution,
                                                     EDolbyIOScreenshareDownscaleQuality DownscaleQuality)
 {
-	if (!IsConnectedAsActive())
+	if (!IsConnectedAsActive() || !Sdk)
 	{
 		return;
 	}
@@ -106,18 +112,18 @@ void UDolbyIOSubsystem::GetCurrentScreenshareSource()
 		        if (!Source)
 		        {
 			        DLB_UE_LOG("Got current screenshare source - none");
-			        BroadcastEvent(OnCurrentScreenshareSourceReceived, bIsSourceNone, FDolbyIOScreenshareSource{});
+			        DLB_BROADCAST(OnCurrentScreenshareSourceReceived, bIsSourceNone, FDolbyIOScreenshareSource{});
 			        return;
 		        }
 		        DLB_UE_LOG("Got current screenshare source - %s", *ToString(*Source));
-		        BroadcastEvent(OnCurrentScreenshareSourceReceived, !bIsSourceNone,
-		                       ToFDolbyIOScreenshareSource(*Source));
+		        DLB_BROADCAST(OnCurrentScreenshareSourceReceived, !bIsSourceNone, ToFDolbyIOScreenshareSource(*Source));
 	        })
 	    .on_error(DLB_ERROR_HANDLER(OnGetScreenshareSourcesError));
 }
 
 void UDolbyIOSubsystem::Handle(const screen_share_error& Event)
 {
+	DLB_TRACE_HANDLER("Handle screen_share_error");
 	DLB_UE_LOG_BASE(Warning, "Received screen_share_error event source=%s type=%s description=%s force_stopped=%d",
 	                *ToString(Event.source), *ToString(Event.type), *ToFString(Event.description), Event.force_stopped);
 	if (Event.force_stopped)
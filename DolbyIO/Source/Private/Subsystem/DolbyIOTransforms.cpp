@@ -2,9 +2,11 @@
 
 #include "DolbyIO.h"
 
+#include "DolbyIOLocalBackend.h"
 #include "Utils/DolbyIOConversions.h"
 #include "Utils/DolbyIOErrorHandler.h"
 #include "Utils/DolbyIOLogging.h"
+#include "Utils/DolbyIOPerformance.h"
 
 #include "Engine/GameInstance.h"
 #include "Engine/World.h"
@@ -26,10 +28,17 @@ void UDolbyIOSubsystem::SetLocalPlayerLocation(const FVector& Location)
 
 void UDolbyIOSubsystem::SetLocalPlayerLocationImpl(const FVector& Location)
 {
-	if (!IsConnectedAsActive() || !IsSpatialAudio())
+	LocalPlayerLocation = Location;
+	if (!IsConnectedAsActive() || !IsSpatialAudio() || (!Sdk && !LocalBackend))
 	{
 		return;
 	}
+	++PerformanceCounters->SpatialUpdates;
+	if (LocalBackend)
+	{
+		LocalBackend->SetSpatialPosition(LocalParticipantID, Location);
+		return;
+	}
 
 	Sdk->conference()
 	    .set_spatial_position(ToStdString(LocalParticipantID), {Location.X, Location.Y, Location.Z})
@@ -48,10 +57,11 @@ void UDolbyIOSubsystem::SetLocalPlayerRotation(const FRotator& Rotation)
 
 void UDolbyIOSubsystem::SetLocalPlayerRotationImpl(const FRotator& Rotation)
 {
-	if (!IsConnectedAsActive() || !IsSpatialAudio())
+	if (!IsConnectedAsActive() || !IsSpatialAudio() || !Sdk)
 	{
 		return;
 	}
+	++PerformanceCounters->SpatialUpdates;
 
 	// The SDK expects the direction values to mean rotations around the {x,y,z} axes as specified by the
 	// environment. In Unreal, rotation around x is roll (because x is forward), y is pitch and z is yaw.
@@ -62,9 +72,16 @@ void UDolbyIOSubsystem::SetLocalPlayerRotationImpl(const FRotator& Rotation)
 
 void UDolbyIOSubsystem::SetRemotePlayerLocation(const FString& ParticipantID, const FVector& Location)
 {
+	RemotePlayerLocations.Add(ParticipantID, Location);
 	if (!IsConnectedAsActive() || SpatialAudioStyle != EDolbyIOSpatialAudioStyle::Individual ||
-	    ParticipantID == LocalParticipantID)
+	    ParticipantID == LocalParticipantID || (!Sdk && !LocalBackend))
+	{
+		return;
+	}
+	++PerformanceCounters->SpatialUpdates;
+	if (LocalBackend)
 	{
+		LocalBackend->SetSpatialPosition(ParticipantID, Location);
 		return;
 	}
 
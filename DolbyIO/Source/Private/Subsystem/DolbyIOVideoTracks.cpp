@@ -2,15 +2,30 @@
 
 #include "DolbyIO.h"
 
+#include "DolbyIOLocalBackend.h"
 #include "Utils/DolbyIOBroadcastEvent.h"
 #include "Utils/DolbyIOConversions.h"
 #include "Utils/DolbyIOErrorHandler.h"
 #include "Utils/DolbyIOLogging.h"
+#include "Utils/DolbyIOTrace.h"
 #include "Video/DolbyIOVideoSink.h"
 
+#include "Algo/Sort.h"
+#include "HAL/IConsoleManager.h"
+
 using namespace dolbyio::comms;
 using namespace DolbyIO;
 
+namespace
+{
+	TAutoConsoleVariable<int32> CVarVideoMemoryBudgetMB{
+	    TEXT("DolbyIO.Video.MemoryBudgetMB"), 0,
+	    TEXT("Memory in MB which the frame buffers and textures of all video tracks should fit in. When it is "
+	         "exceeded, remote tracks are converted at half or quarter resolution, starting with participants who are "
+	         "not speaking, whose tracks are not bound to any material and who are furthest away. 0 disables the "
+	         "budget.")};
+}
+
 void UDolbyIOSubsystem::BindMaterial(UMaterialInstanceDynamic* Material, const FString& VideoTrackID)
 {
 	FScopeLock Lock{&VideoSinksLock};
@@ -47,11 +62,113 @@ UTexture2D* UDolbyIOSubsystem::GetTexture(const FString& VideoTrackID)
 	return nullptr;
 }
 
+void UDolbyIOSubsystem::UpdateVideoStats()
+{
+#if DLB_VIDEO_STATS
+	FScopeLock Lock{&VideoSinksLock};
+	for (auto& Sink : VideoSinks)
+	{
+		Sink.Value->UpdateStats(VideoStatsInterval);
+	}
+#endif
+}
+
+void UDolbyIOSubsystem::ApplyVideoMemoryBudget()
+{
+	struct FTrack
+	{
+		FVideoSink* Sink;
+		bool bIsSpeaking;
+		bool bIsVisible;
+		double DistanceSquared;
+		int Shift;
+	};
+
+	const SIZE_T Budget = static_cast<SIZE_T>(FMath::Max(CVarVideoMemoryBudgetMB.GetValueOnGameThread(), 0)) << 20;
+	VideoMemoryBudget = Budget;
+	TSet<FString> Speakers;
+	{
+		FScopeLock Lock{&ActiveSpeakersLock};
+		Speakers = ActiveSpeakerIDs;
+	}
+
+	FScopeLock Lock{&VideoSinksLock};
+	TArray<FTrack> Tracks;
+	SIZE_T Usage = 0;
+	for (auto& Sink : VideoSinks)
+	{
+		Usage += Sink.Value->EstimateMemorySize(0);
+		const FString& ParticipantID = Sink.Value->GetParticipantID();
+		if (!ParticipantID.IsEmpty())
+		{
+			const FVector* Location = RemotePlayerLocations.Find(ParticipantID);
+			Tracks.Add(FTrack{Sink.Value.get(), Speakers.Contains(ParticipantID), Sink.Value->HasMaterials(),
+			                  Location ? FVector::DistSquared(*Location, LocalPlayerLocation) : 0.0, 0});
+		}
+	}
+
+	if (Budget && Usage > Budget)
+	{
+		// Lowest priority first
+		Algo::Sort(Tracks,
+		           [](const FTrack& Lhs, const FTrack& Rhs)
+		           {
+			           if (Lhs.bIsSpeaking != Rhs.bIsSpeaking)
+			           {
+				           return !Lhs.bIsSpeaking;
+			           }
+			           if (Lhs.bIsVisible != Rhs.bIsVisible)
+			           {
+				           return !Lhs.bIsVisible;
+			           }
+			           return Lhs.DistanceSquared > Rhs.DistanceSquared;
+		           });
+
+		// Halve all tracks in priority order before quartering any. Pausing tracks would not help, since a paused
+		// track keeps its frame buffers and textures to show its last frame.
+		for (int Shift = 1; Shift <= FVideoSink::MaxDownscaleShift && Usage > Budget; ++Shift)
+		{
+			for (FTrack& Track : Tracks)
+			{
+				if (Usage <= Budget)
+				{
+					break;
+				}
+				Usage -= Track.Sink->EstimateMemorySize(Track.Shift) - Track.Sink->EstimateMemorySize(Shift);
+				Track.Shift = Shift;
+			}
+		}
+	}
+
+	int NumDownscaled = 0;
+	for (const FTrack& Track : Tracks)
+	{
+		if (Track.Shift != Track.Sink->GetDownscaleShift())
+		{
+			DLB_UE_LOG_BASE(Verbose, "Video track of participant %s downscaled by %d", *Track.Sink->GetParticipantID(),
+			                1 << Track.Shift);
+			Track.Sink->SetDownscale(Track.Shift);
+		}
+		NumDownscaled += Track.Shift > 0;
+	}
+
+	SIZE_T UsedMemory = 0;
+	for (auto& Sink : VideoSinks)
+	{
+		UsedMemory += Sink.Value->GetMemorySize();
+	}
+	SET_MEMORY_STAT(STAT_DolbyIO_VideoMemory, UsedMemory);
+	SET_MEMORY_STAT(STAT_DolbyIO_VideoMemoryBudget, Budget);
+	SET_DWORD_STAT(STAT_DolbyIO_DownscaledTracks, NumDownscaled);
+	CSV_CUSTOM_STAT(DolbyIO, VideoMemoryMB, UsedMemory / 1048576.0f, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(DolbyIO, VideoMemoryBudgetMB, Budget / 1048576.0f, ECsvCustomStatOp::Set);
+}
+
 void UDolbyIOSubsystem::BroadcastVideoTrackAdded(const FDolbyIOVideoTrack& VideoTrack)
 {
 	DLB_UE_LOG("Video track added: TrackID=%s ParticipantID=%s", *VideoTrack.TrackID, *VideoTrack.ParticipantID);
 	WarnIfVideoTrackSuspicious(VideoTrack.TrackID);
-	BroadcastEvent(OnVideoTrackAdded, VideoTrack);
+	DLB_BROADCAST(OnVideoTrackAdded, VideoTrack);
 }
 
 void UDolbyIOSubsystem::WarnIfVideoTrackSuspicious(const FString& VideoTrackID)
@@ -65,11 +182,12 @@ void UDolbyIOSubsystem::WarnIfVideoTrackSuspicious(const FString& VideoTrackID)
 void UDolbyIOSubsystem::BroadcastVideoTrackEnabled(const FDolbyIOVideoTrack& VideoTrack)
 {
 	DLB_UE_LOG("Video track enabled: TrackID=%s ParticipantID=%s", *VideoTrack.TrackID, *VideoTrack.ParticipantID);
-	BroadcastEvent(OnVideoTrackEnabled, VideoTrack);
+	DLB_BROADCAST(OnVideoTrackEnabled, VideoTrack);
 }
 
 void UDolbyIOSubsystem::ProcessBufferedVideoTracks(const FString& ParticipantID)
 {
+	FScopeLock BufferedLock{&BufferedVideoTracksLock};
 	if (TArray<FDolbyIOVideoTrack>* AddedTracks = BufferedAddedVideoTracks.Find(ParticipantID))
 	{
 		FScopeLock Lock{&VideoSinksLock};
@@ -82,6 +200,7 @@ void UDolbyIOSubsystem::ProcessBufferedVideoTracks(const FString& ParticipantID)
 				    {
 					    BroadcastVideoTrackAdded(AddedTrack);
 
+					    FScopeLock CallbackLock{&BufferedVideoTracksLock};
 					    if (TArray<FDolbyIOVideoTrack>* EnabledTracks = BufferedEnabledVideoTracks.Find(ParticipantID))
 					    {
 						    TArray<FDolbyIOVideoTrack>& EnabledTracksRef = *EnabledTracks;
@@ -108,14 +227,29 @@ void UDolbyIOSubsystem::ProcessBufferedVideoTracks(const FString& ParticipantID)
 
 void UDolbyIOSubsystem::Handle(const remote_video_track_added& Event)
 {
+	DLB_TRACE_HANDLER("Handle remote_video_track_added");
 	const FDolbyIOVideoTrack VideoTrack = ToFDolbyIOVideoTrack(Event.track);
 
+	FScopeLock BufferedLock{&BufferedVideoTracksLock};
 	FScopeLock Lock1{&VideoSinksLock};
-	VideoSinks.Emplace(VideoTrack.TrackID, std::make_shared<FVideoSink>(VideoTrack.TrackID));
-	Sdk->video()
-	    .remote()
-	    .set_video_sink(Event.track, VideoSinks[VideoTrack.TrackID])
-	    .on_error(DLB_ERROR_HANDLER_NO_DELEGATE);
+	VideoSinks.Emplace(VideoTrack.TrackID, std::make_shared<FVideoSink>(VideoTrack.TrackID, VideoTrack.ParticipantID));
+	if (VideoTrack.bIsScreenshare)
+	{
+		VideoSinks[VideoTrack.TrackID]->EnableDirtyRegionUploads();
+	}
+	VideoSinks[VideoTrack.TrackID]->SetTraceRecorder(std::atomic_load(&TraceRecorder));
+	PublishVideoSinks();
+	if (LocalBackend)
+	{
+		LocalBackend->SetVideoSink(VideoTrack.TrackID, VideoSinks[VideoTrack.TrackID]);
+	}
+	else if (Sdk) // not when replaying a trace
+	{
+		Sdk->video()
+		    .remote()
+		    .set_video_sink(Event.track, VideoSinks[VideoTrack.TrackID])
+		    .on_error(DLB_ERROR_HANDLER_NO_DELEGATE);
+	}
 
 	FScopeLock Lock2{&RemoteParticipantsLock};
 	if (RemoteParticipants.Contains(VideoTrack.ParticipantID))
@@ -132,6 +266,7 @@ void UDolbyIOSubsystem::Handle(const remote_video_track_added& Event)
 
 void UDolbyIOSubsystem::Handle(const remote_video_track_removed& Event)
 {
+	DLB_TRACE_HANDLER("Handle remote_video_track_removed");
 	const FDolbyIOVideoTrack VideoTrack = ToFDolbyIOVideoTrack(Event.track);
 	DLB_UE_LOG("Video track removed: TrackID=%s ParticipantID=%s", *VideoTrack.TrackID, *VideoTrack.ParticipantID);
 	WarnIfVideoTrackSuspicious(VideoTrack.TrackID);
@@ -141,21 +276,25 @@ void UDolbyIOSubsystem::Handle(const remote_video_track_removed& Event)
 	{
 		(*Sink)->UnbindAllMaterials();
 		VideoSinks.Remove(VideoTrack.TrackID);
+		PublishVideoSinks();
 	}
 	else
 	{
 		DLB_UE_LOG_BASE(Warning, "Non-existent video track removed");
 	}
 
-	BroadcastEvent(OnVideoTrackRemoved, VideoTrack);
+	DLB_BROADCAST(OnVideoTrackRemoved, VideoTrack);
 }
 
 void UDolbyIOSubsystem::Handle(const utils::vfs_event& Event)
 {
+	DLB_TRACE_HANDLER("Handle vfs_event");
 	for (const auto& TrackMapItem : Event.new_enabled)
 	{
 		const FDolbyIOVideoTrack VideoTrack = ToFDolbyIOVideoTrack(TrackMapItem);
 
+		// Textures are created on the game thread, which also flushes the buffered tracks once they exist
+		FScopeLock BufferedLock{&BufferedVideoTracksLock};
 		if (GetTexture(VideoTrack.TrackID))
 		{
 			BroadcastVideoTrackEnabled(VideoTrack);
@@ -171,6 +310,6 @@ void UDolbyIOSubsystem::Handle(const utils::vfs_event& Event)
 	{
 		const FDolbyIOVideoTrack VideoTrack = ToFDolbyIOVideoTrack(TrackMapItem);
 		DLB_UE_LOG("Video track ID %s for participant ID %s disabled", *VideoTrack.TrackID, *VideoTrack.ParticipantID);
-		BroadcastEvent(OnVideoTrackDisabled, VideoTrack);
+		DLB_BROADCAST(OnVideoTrackDisabled, VideoTrack);
 	}
 }
@@ -0,0 +1,193 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "Utils/DolbyIOAudioLevels.h"
+
+#include "Utils/DolbyIOCppSdk.h"
+
+#include "Containers/StringConv.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Hash/CityHash.h"
+#include "Math/VectorRegister.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+namespace DolbyIO
+{
+	namespace
+	{
+		TAutoConsoleVariable<float> CVarAttackMs{
+		    TEXT("DolbyIO.AudioLevels.AttackMs"), 0.f,
+		    TEXT("Time constant in milliseconds with which polled audio levels rise, 0 means no smoothing.")};
+		TAutoConsoleVariable<float> CVarReleaseMs{
+		    TEXT("DolbyIO.AudioLevels.ReleaseMs"), 0.f,
+		    TEXT("Time constant in milliseconds with which polled audio levels fall, 0 means no smoothing.")};
+
+#if ENGINE_MAJOR_VERSION == 5
+		using FVectorRegister = VectorRegister4Float;
+#else
+		using FVectorRegister = VectorRegister;
+#endif
+		constexpr int32 VectorWidth = 4;
+
+		uint64 MakeKey(const char* ParticipantID, int32 Length)
+		{
+			return CityHash64(ParticipantID, Length);
+		}
+
+		// Fraction of the distance to the target covered in the given time, all of it without smoothing
+		float GetSmoothingRate(double ElapsedSeconds, float TimeConstantMs)
+		{
+			if (TimeConstantMs <= 0.f)
+			{
+				return 1.f;
+			}
+			return static_cast<float>(1.0 - FMath::Exp(-FMath::Max(ElapsedSeconds, 0.0) * 1000.0 / TimeConstantMs));
+		}
+	}
+
+	void FAudioLevelTable::Update(const dolbyio::comms::audio_levels& Event)
+	{
+		const uint32 CurrentGeneration = Generation.load(std::memory_order_acquire);
+		if (CurrentGeneration != WriterGeneration)
+		{
+			WriterGeneration = CurrentGeneration;
+			FMemory::Memzero(Keys, Num * sizeof(uint64));
+			FMemory::Memzero(Targets, Num * sizeof(float));
+			FMemory::Memzero(Levels, Num * sizeof(float));
+			Num = 0;
+			LastUpdate = -1.0;
+		}
+
+		// Levels have been moving towards the previous targets since the last update
+		Smooth(FPlatformTime::Seconds());
+
+		for (int32 i = 0; i < Num; ++i)
+		{
+			Targets[i] = 0.f;
+		}
+		for (const dolbyio::comms::audio_level& Level : Event.levels)
+		{
+			const uint64 Key = MakeKey(Level.participant_id.data(), static_cast<int32>(Level.participant_id.size()));
+			int32 Index = 0;
+			while (Index < Num && Keys[Index] != Key)
+			{
+				++Index;
+			}
+			if (Index == Num)
+			{
+				if (Num == MaxParticipants)
+				{
+					continue;
+				}
+				Keys[Num++] = Key;
+			}
+			Targets[Index] = Level.level;
+		}
+
+		for (int32 i = Num - 1; i >= 0; --i)
+		{
+			if (Targets[i] == 0.f && Levels[i] < SilenceThreshold)
+			{
+				--Num;
+				Keys[i] = Keys[Num];
+				Targets[i] = Targets[Num];
+				Levels[i] = Levels[Num];
+				Keys[Num] = 0;
+				Targets[Num] = 0.f;
+				Levels[Num] = 0.f;
+			}
+		}
+
+		Publish();
+	}
+
+	void FAudioLevelTable::Smooth(double Now)
+	{
+		const double Elapsed = LastUpdate < 0.0 ? 0.0 : Now - LastUpdate;
+		LastUpdate = Now;
+
+		const float AttackRate = GetSmoothingRate(Elapsed, CVarAttackMs.GetValueOnAnyThread());
+		const float ReleaseRate = GetSmoothingRate(Elapsed, CVarReleaseMs.GetValueOnAnyThread());
+		const FVectorRegister Attack = VectorSetFloat1(AttackRate);
+		const FVectorRegister Release = VectorSetFloat1(ReleaseRate);
+		// The entries past Num are silent, so the last partial vector can be processed whole
+		for (int32 i = 0; i < Num; i += VectorWidth)
+		{
+			const FVectorRegister Target = VectorLoadAligned(&Targets[i]);
+			const FVectorRegister Level = VectorLoadAligned(&Levels[i]);
+			const FVectorRegister Rate = VectorSelect(VectorCompareGT(Target, Level), Attack, Release);
+			VectorStoreAligned(VectorMultiplyAdd(VectorSubtract(Target, Level), Rate, Level), &Levels[i]);
+		}
+	}
+
+	void FAudioLevelTable::Publish()
+	{
+		const int32 Index = 1 - Published.load(std::memory_order_relaxed);
+		FBuffer& Buffer = Buffers[Index];
+
+		Buffer.Sequence.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		Buffer.Generation = WriterGeneration;
+		Buffer.Num = Num;
+		Buffer.UpdateTime = LastUpdate;
+		FMemory::Memcpy(Buffer.Keys, Keys, Num * sizeof(uint64));
+		FMemory::Memcpy(Buffer.Targets, Targets, Num * sizeof(float));
+		FMemory::Memcpy(Buffer.Levels, Levels, Num * sizeof(float));
+		Buffer.Sequence.fetch_add(1, std::memory_order_release);
+
+		Published.store(Index, std::memory_order_release);
+	}
+
+	void FAudioLevelTable::Reset()
+	{
+		Generation.fetch_add(1, std::memory_order_release);
+	}
+
+	float FAudioLevelTable::GetAudioLevel(const FString& ParticipantID) const
+	{
+		const FTCHARToUTF8 ID{*ParticipantID, ParticipantID.Len()};
+		const uint64 Key = MakeKey(reinterpret_cast<const char*>(ID.Get()), ID.Length());
+		const uint32 CurrentGeneration = Generation.load(std::memory_order_acquire);
+		for (;;)
+		{
+			const FBuffer& Buffer = Buffers[Published.load(std::memory_order_acquire)];
+			const uint32 Sequence = Buffer.Sequence.load(std::memory_order_acquire);
+			if (Sequence & 1)
+			{
+				continue;
+			}
+
+			bool bIsFound = false;
+			float Target = 0.f;
+			float Level = 0.f;
+			const double UpdateTime = Buffer.UpdateTime;
+			const int32 BufferNum =
+			    Buffer.Generation == CurrentGeneration ? FMath::Clamp(Buffer.Num, 0, MaxParticipants) : 0;
+			for (int32 i = 0; i < BufferNum; ++i)
+			{
+				if (Buffer.Keys[i] == Key)
+				{
+					bIsFound = true;
+					Target = Buffer.Targets[i];
+					Level = Buffer.Levels[i];
+					break;
+				}
+			}
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Buffer.Sequence.load(std::memory_order_relaxed) != Sequence)
+			{
+				continue;
+			}
+			if (!bIsFound)
+			{
+				return 0.f;
+			}
+
+			// Evaluated at read time, so that levels polled every frame move smoothly between updates
+			const float TimeConstantMs =
+			    Target > Level ? CVarAttackMs.GetValueOnAnyThread() : CVarReleaseMs.GetValueOnAnyThread();
+			return Level + (Target - Level) * GetSmoothingRate(FPlatformTime::Seconds() - UpdateTime, TimeConstantMs);
+		}
+	}
+}
@@ -0,0 +1,66 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "DolbyIOCppSdkFwd.h"
+
+#include "Containers/UnrealString.h"
+
+#include <atomic>
+
+namespace DolbyIO
+{
+	// Latest audio level of every speaking participant, for code which polls them every frame. Written by the
+	// audio_levels handler, one update at a time, and read from any thread without locking or allocating.
+	//
+	// Participants are keyed by a hash of their ID and the table is laid out as parallel arrays of keys and levels.
+	// Each update is written to the buffer readers are not pointed at, which is then published. A sequence number per
+	// buffer lets the rare reader still in a buffer being rewritten retry on the published one.
+	//
+	// Levels are smoothed with the DolbyIO.AudioLevels.AttackMs and DolbyIO.AudioLevels.ReleaseMs time constants. Each
+	// entry holds the level reached at the last update and the target it moves towards from then on, so that readers
+	// evaluate the envelope at the time they read it and see it move every frame rather than at the SDK's rate. Updates
+	// advance all entries in one vectorized pass. Participants missing from an update are released towards silence and
+	// dropped once silent.
+	//
+	// Reset may be called from any thread. Readers get silence from then on until the next update, which starts over.
+	class FAudioLevelTable final
+	{
+	public:
+		void Update(const dolbyio::comms::audio_levels& Event);
+		void Reset();
+
+		float GetAudioLevel(const FString& ParticipantID) const;
+
+	private:
+		static constexpr int32 MaxParticipants = 256;
+		static constexpr float SilenceThreshold = 1e-3f;
+
+		struct FBuffer
+		{
+			std::atomic<uint32> Sequence{0};
+			uint32 Generation = 0;
+			int32 Num = 0;
+			double UpdateTime = 0.0;
+			uint64 Keys[MaxParticipants]{};
+			float Targets[MaxParticipants]{};
+			float Levels[MaxParticipants]{};
+		};
+
+		void Smooth(double Now);
+		void Publish();
+
+		FBuffer Buffers[2];
+		std::atomic<int32> Published{0};
+		// Incremented by Reset. Buffers of an older generation read as silence.
+		std::atomic<uint32> Generation{0};
+
+		// Writer state, padded with silent entries up to a multiple of the vector width
+		int32 Num = 0;
+		alignas(16) uint64 Keys[MaxParticipants]{};
+		alignas(16) float Targets[MaxParticipants]{};
+		alignas(16) float Levels[MaxParticipants]{};
+		double LastUpdate = -1.0;
+		uint32 WriterGeneration = 0;
+	};
+}
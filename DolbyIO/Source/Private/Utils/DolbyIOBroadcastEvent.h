@@ -2,12 +2,17 @@
 
 #pragma once
 
-#include "Async/Async.h"
+#include "DolbyIO.h"
+#include "Utils/DolbyIOEventQueue.h"
+#include "Utils/DolbyIOMemory.h"
 
-namespace DolbyIO
+// Broadcasts an event of the subsystem together with its native counterpart
+#define DLB_BROADCAST(Event, ...) GetSubsystem().BroadcastEvent(Event, Event##Native, ##__VA_ARGS__)
+
+// Can be called from any thread, the event is broadcast on the game thread when the subsystem drains its event queue
+template <class TDelegate, class TNativeDelegate, class... TArgs>
+void UDolbyIOSubsystem::BroadcastEvent(TDelegate& Event, TNativeDelegate& NativeEvent, TArgs&&... Args) const
 {
-	template <class TDelegate, class... TArgs> void BroadcastEvent(TDelegate& Event, TArgs&&... Args)
-	{
-		AsyncTask(ENamedThreads::GameThread, [=] { Event.Broadcast(Args...); });
-	}
+	LLM_SCOPE_BYTAG(DolbyIO_Events);
+	EventQueue->Push(Event, NativeEvent, Forward<TArgs>(Args)...);
 }
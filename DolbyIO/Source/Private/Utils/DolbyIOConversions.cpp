@@ -182,6 +182,17 @@ namespace DolbyIO
 		return Ret;
 	}
 
+	utils::participant_track_map::mapped_type ToSdkTrackMapValue(const std::string& VideoTrackID)
+	{
+		utils::participant_track_map::mapped_type Ret{};
+#if PLATFORM_ANDROID // SDK 2.7
+		Ret.sdp_track_id = VideoTrackID;
+#else // SDK 2.6
+		std::get<1>(Ret) = VideoTrackID;
+#endif
+		return Ret;
+	}
+
 	spatial_audio_style ToSdkSpatialAudioStyle(EDolbyIOSpatialAudioStyle SpatialAudioStyle)
 	{
 		switch (SpatialAudioStyle)
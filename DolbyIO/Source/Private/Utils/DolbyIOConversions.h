@@ -26,6 +26,7 @@ namespace DolbyIO
 	FDolbyIOVideoTrack ToFDolbyIOVideoTrack(const dolbyio::comms::video_track& Track);
 	FDolbyIOVideoTrack ToFDolbyIOVideoTrack(
 	    const dolbyio::comms::utils::participant_track_map::value_type& TrackMapItem);
+	dolbyio::comms::utils::participant_track_map::mapped_type ToSdkTrackMapValue(const std::string& VideoTrackID);
 
 	dolbyio::comms::spatial_audio_style ToSdkSpatialAudioStyle(EDolbyIOSpatialAudioStyle SpatialAudioStyle);
 	dolbyio::comms::screen_share_content_info ToSdkContentInfo(EDolbyIOScreenshareEncoderHint EncoderHint,
@@ -6,7 +6,9 @@
 #include "Utils/DolbyIOBroadcastEvent.h"
 #include "Utils/DolbyIOConversions.h"
 #include "Utils/DolbyIOLogging.h"
+#include "Utils/DolbyIOTrace.h"
 
+#include "Async/Async.h"
 #include "Misc/Paths.h"
 
 namespace DolbyIO
@@ -19,8 +21,10 @@ namespace DolbyIO
 	}
 
 	FErrorHandler::FErrorHandler(const FString& File, int Line, UDolbyIOSubsystem& DolbyIOSubsystem,
-	                             const FDolbyIOOnErrorDelegate& OnError)
-	    : File(FPaths::GetCleanFilename(File)), Line(Line), DolbyIOSubsystem(DolbyIOSubsystem), OnError(&OnError)
+	                             const FDolbyIOOnErrorDelegate& OnError,
+	                             const FDolbyIOOnErrorNativeDelegate& OnErrorNative)
+	    : File(FPaths::GetCleanFilename(File)), Line(Line), DolbyIOSubsystem(DolbyIOSubsystem), OnError(&OnError),
+	      OnErrorNative(&OnErrorNative)
 	{
 	}
 
@@ -101,18 +105,23 @@ namespace DolbyIO
 
 	void FErrorHandler::LogException(const FString& Type, const FString& What) const
 	{
+		DLB_TRACE_SCOPE("Error");
+		TRACE_COUNTER_INCREMENT(DolbyIO_Errors);
 		const FString ErrorMsg = Type + ": " + What;
 		DLB_UE_LOG_BASE(Error, "Caught %s (conference status: %s, %s:%d)", *ErrorMsg,
 		                *ToString(DolbyIOSubsystem.ConferenceStatus), *File, Line);
 		if (OnError)
 		{
-			BroadcastEvent(*OnError, ErrorMsg);
+			DolbyIOSubsystem.BroadcastEvent(*OnError, *OnErrorNative, ErrorMsg);
 		}
 	}
 
-	void FErrorHandler::Warn(const FDolbyIOOnErrorDelegate& OnError, const FString& Msg)
+	void FErrorHandler::Warn(const UDolbyIOSubsystem& DolbyIOSubsystem, const FDolbyIOOnErrorDelegate& OnError,
+	                         const FDolbyIOOnErrorNativeDelegate& OnErrorNative, const FString& Msg)
 	{
+		DLB_TRACE_SCOPE("Warning");
+		TRACE_COUNTER_INCREMENT(DolbyIO_Errors);
 		DLB_UE_LOG_BASE(Warning, "%s", *Msg);
-		BroadcastEvent(OnError, Msg);
+		DolbyIOSubsystem.BroadcastEvent(OnError, OnErrorNative, Msg);
 	}
 }
@@ -2,29 +2,29 @@
 
 #pragma once
 
-#include "Containers/UnrealString.h"
+#include "DolbyIO.h"
 
-class UDolbyIOSubsystem;
-class FDolbyIOOnErrorDelegate;
+#include "Containers/UnrealString.h"
 
 namespace DolbyIO
 {
 	class FErrorHandler final
 	{
 	public:
-#define DLB_ERROR_HANDLER(OnError) FErrorHandler(__FILE__, __LINE__, GetSubsystem(), OnError)
+#define DLB_ERROR_HANDLER(OnError) FErrorHandler(__FILE__, __LINE__, GetSubsystem(), OnError, OnError##Native)
 #define DLB_ERROR_HANDLER_NO_DELEGATE FErrorHandler(__FILE__, __LINE__, GetSubsystem())
 
-#define DLB_WARNING(OnError, Msg) FErrorHandler::Warn(OnError, Msg)
+#define DLB_WARNING(OnError, Msg) FErrorHandler::Warn(GetSubsystem(), OnError, OnError##Native, Msg)
 
 		FErrorHandler(const FString& File, int Line, UDolbyIOSubsystem& DolbyIOSubsystem);
 		FErrorHandler(const FString& File, int Line, UDolbyIOSubsystem& DolbyIOSubsystem,
-		              const FDolbyIOOnErrorDelegate& OnError);
+		              const FDolbyIOOnErrorDelegate& OnError, const FDolbyIOOnErrorNativeDelegate& OnErrorNative);
 
 		void operator()(std::exception_ptr&& ExcPtr) const;
 		void HandleError() const;
 
-		static void Warn(const FDolbyIOOnErrorDelegate& OnError, const FString& Msg);
+		static void Warn(const UDolbyIOSubsystem& DolbyIOSubsystem, const FDolbyIOOnErrorDelegate& OnError,
+		                 const FDolbyIOOnErrorNativeDelegate& OnErrorNative, const FString& Msg);
 
 	private:
 		void HandleError(TFunction<void()> Callee) const;
@@ -35,5 +35,6 @@ namespace DolbyIO
 		const int Line;
 		const UDolbyIOSubsystem& DolbyIOSubsystem;
 		const FDolbyIOOnErrorDelegate* const OnError{};
+		const FDolbyIOOnErrorNativeDelegate* const OnErrorNative{};
 	};
 }
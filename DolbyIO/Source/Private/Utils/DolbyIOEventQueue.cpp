@@ -0,0 +1,207 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "Utils/DolbyIOEventQueue.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+namespace DolbyIO
+{
+	namespace
+	{
+		TAutoConsoleVariable<float> CVarDispatchBudgetMs{
+		    TEXT("DolbyIO.Events.DispatchBudgetMs"), 0.f,
+		    TEXT("Time in milliseconds the game thread may spend broadcasting Dolby.io events per tick, the remaining ")
+		        TEXT("events are broadcast on the next ticks. 0 means no limit.")};
+	}
+
+	FEventQueue::FEventQueue(TFunction<void()> InOnTick) : OnTick(MoveTemp(InOnTick))
+	{
+#if ENGINE_MAJOR_VERSION == 5
+		TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FEventQueue::Tick));
+#else
+		TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FEventQueue::Tick));
+#endif
+	}
+
+	FEventQueue::~FEventQueue()
+	{
+#if ENGINE_MAJOR_VERSION == 5
+		FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#else
+		FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+#endif
+
+		// Events which were never broadcast are traced as dropped, so that the pending counters stay balanced
+		for (FEvent* Event = Head.exchange(nullptr); Event;)
+		{
+			FEvent* Next = Event->Next;
+			TraceBroadcastDropped(Event->BroadcastID);
+			Destroy(Event);
+			Event = Next;
+		}
+		for (FEvent* Event = Pending; Event;)
+		{
+			FEvent* Next = Event->Next;
+			TraceBroadcastDropped(Event->BroadcastID);
+			Destroy(Event);
+			Event = Next;
+		}
+		for (int32 i = 0; i < NumLatestSlots; ++i)
+		{
+			if (FEvent* Event = LatestSlots[i].Event.exchange(nullptr))
+			{
+				TraceBroadcastDropped(Event->BroadcastID);
+				Destroy(Event);
+			}
+		}
+	}
+
+	void FEventQueue::CoalesceLatest(const void* Delegate, const FString& Name, IConsoleVariable* bEnabled)
+	{
+		check(NumLatestSlots < MaxLatestSlots);
+		FLatestSlot& Slot = LatestSlots[NumLatestSlots++];
+		Slot.Delegate = Delegate;
+		Slot.Name = Name;
+		Slot.bEnabled = bEnabled;
+	}
+
+	void FEventQueue::GetCoalescedEventCounters(TArray<FDolbyIOEventCounters>& Counters) const
+	{
+		if (Counters.Num() != NumLatestSlots)
+		{
+			Counters.SetNum(NumLatestSlots);
+			for (int32 i = 0; i < NumLatestSlots; ++i)
+			{
+				Counters[i].Event = LatestSlots[i].Name;
+			}
+		}
+		for (int32 i = 0; i < NumLatestSlots; ++i)
+		{
+			Counters[i].Received = LatestSlots[i].Received;
+			Counters[i].Delivered = LatestSlots[i].Delivered;
+		}
+	}
+
+	void FEventQueue::Push(FEvent* Event)
+	{
+		Event->BroadcastID = TraceBroadcastQueued();
+		NumPending.fetch_add(1, std::memory_order_relaxed);
+
+		FEvent* OldHead = Head.load(std::memory_order_relaxed);
+		do
+		{
+			Event->Next = OldHead;
+		} while (!Head.compare_exchange_weak(OldHead, Event, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	void FEventQueue::Push(FLatestSlot& Slot, FEvent* Event)
+	{
+		++Slot.Received;
+		Event->Delivered = &Slot.Delivered;
+		if (!Slot.bEnabled->GetBool())
+		{
+			Push(Event);
+			return;
+		}
+
+		Event->BroadcastID = TraceBroadcastQueued();
+		NumPending.fetch_add(1, std::memory_order_relaxed);
+		// Whoever takes an event out of the slot owns it, so the replaced one cannot be broadcast concurrently
+		if (FEvent* Replaced = Slot.Event.exchange(Event, std::memory_order_acq_rel))
+		{
+			TraceBroadcastDropped(Replaced->BroadcastID);
+			Destroy(Replaced);
+		}
+	}
+
+	void FEventQueue::Broadcast(FEvent* Event)
+	{
+		DLB_TRACE_SCOPE("Broadcast");
+		TraceBroadcastDispatched(Event->BroadcastID);
+		Event->Broadcast();
+		if (Event->Delivered)
+		{
+			++*Event->Delivered;
+		}
+		Destroy(Event);
+	}
+
+	void FEventQueue::Destroy(FEvent* Event)
+	{
+		NumPending.fetch_sub(1, std::memory_order_relaxed);
+		const bool bIsInArena = Event->bIsInArena;
+		Event->~FEvent();
+		if (bIsInArena)
+		{
+			Arena.Free(Event);
+		}
+		else
+		{
+			FMemory::Free(Event);
+		}
+	}
+
+	bool FEventQueue::Tick(float DeltaTime)
+	{
+		if (OnTick)
+		{
+			OnTick();
+		}
+		BroadcastQueued();
+		for (int32 i = 0; i < NumLatestSlots; ++i)
+		{
+			if (FEvent* Event = LatestSlots[i].Event.exchange(nullptr, std::memory_order_acquire))
+			{
+				Broadcast(Event);
+			}
+		}
+		return true;
+	}
+
+	void FEventQueue::BroadcastQueued()
+	{
+		FEvent* Pushed = Head.exchange(nullptr, std::memory_order_acquire);
+		if (!Pushed && !Pending)
+		{
+			return;
+		}
+
+		DLB_TRACE_SCOPE("Dispatch events");
+
+		// Reverse the pushed events to broadcast them in order, after the ones left over by the previous tick
+		FEvent* Oldest = nullptr;
+		FEvent* Newest = Pushed;
+		while (Pushed)
+		{
+			FEvent* Next = Pushed->Next;
+			Pushed->Next = Oldest;
+			Oldest = Pushed;
+			Pushed = Next;
+		}
+		if (Oldest)
+		{
+			(PendingTail ? PendingTail->Next : Pending) = Oldest;
+			PendingTail = Newest;
+		}
+
+		const double BudgetSeconds = CVarDispatchBudgetMs.GetValueOnGameThread() / 1000.0;
+		const double Start = FPlatformTime::Seconds();
+		while (Pending)
+		{
+			FEvent* Event = Pending;
+			Pending = Event->Next;
+			if (!Pending)
+			{
+				PendingTail = nullptr;
+			}
+			Broadcast(Event);
+
+			// At least one event is broadcast per tick so that the queue always makes progress
+			if (BudgetSeconds > 0.0 && FPlatformTime::Seconds() - Start >= BudgetSeconds)
+			{
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,164 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "DolbyIOTypes.h"
+#include "Utils/DolbyIOTrace.h"
+
+#include "Containers/Array.h"
+#include "Containers/LockFreeFixedSizeAllocator.h"
+#include "Containers/Ticker.h"
+#include "HAL/UnrealMemory.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Templates/Function.h"
+#include "Templates/Tuple.h"
+
+class IConsoleVariable;
+
+#include <atomic>
+#include <type_traits>
+
+namespace DolbyIO
+{
+	// Events pushed by the threads handling SDK events and broadcast on the game thread, which drains the queue once
+	// per engine tick, within the DolbyIO.Events.DispatchBudgetMs budget if one is set. Pushing is lock-free and
+	// events are allocated from a recycled arena, so that handlers neither contend nor allocate per event once the
+	// arena is warm. Payloads are moved into the queued event and broadcast from there.
+	//
+	// Events of a delegate registered with CoalesceLatest are not queued while its console variable is set. Only the
+	// latest one pushed between two ticks is kept and broadcast after the queued events, the others are dropped.
+	//
+	// OnTick is called on the game thread at the start of every tick, before anything is broadcast.
+	class FEventQueue final
+	{
+	public:
+		explicit FEventQueue(TFunction<void()> InOnTick);
+		~FEventQueue();
+
+		// Must be called before any event of the delegate is pushed
+		void CoalesceLatest(const void* Delegate, const FString& Name, IConsoleVariable* bEnabled);
+
+		template <class TDelegate, class TNativeDelegate, class... TArgs>
+		void Push(TDelegate& Delegate, TNativeDelegate& NativeDelegate, TArgs&&... Args)
+		{
+			using FTypedEvent = TEvent<TDelegate, TNativeDelegate, std::decay_t<TArgs>...>;
+			constexpr bool bFitsArena = sizeof(FTypedEvent) <= BlockSize && alignof(FTypedEvent) <= BlockAlignment;
+			void* Memory = bFitsArena ? Arena.Allocate() : FMemory::Malloc(sizeof(FTypedEvent), alignof(FTypedEvent));
+			FEvent* Event = new (Memory) FTypedEvent(Delegate, NativeDelegate, Forward<TArgs>(Args)...);
+			Event->bIsInArena = bFitsArena;
+
+			if (FLatestSlot* Slot = FindLatestSlot(&Delegate))
+			{
+				Push(*Slot, Event);
+			}
+			else
+			{
+				Push(Event);
+			}
+		}
+
+		// The number of events pushed but not broadcast yet, readable from any thread
+		int32 GetNumPending() const
+		{
+			return NumPending.load(std::memory_order_relaxed);
+		}
+
+		// Only sets the names when the array is new, so that counters polled into the same array do not allocate
+		void GetCoalescedEventCounters(TArray<FDolbyIOEventCounters>& Counters) const;
+
+	private:
+		struct FEvent
+		{
+			virtual ~FEvent() = default;
+			virtual void Broadcast() = 0;
+
+			FEvent* Next = nullptr;
+			std::atomic<uint64>* Delivered = nullptr;
+			uint32 BroadcastID = 0;
+			bool bIsInArena = false;
+		};
+
+		struct FLatestSlot
+		{
+			const void* Delegate = nullptr;
+			FString Name;
+			IConsoleVariable* bEnabled = nullptr;
+			std::atomic<FEvent*> Event{nullptr};
+			std::atomic<uint64> Received{0};
+			std::atomic<uint64> Delivered{0};
+		};
+
+		// Broadcasts the native delegate and then the dynamic one, the latter only if bound since it goes through
+		// reflection even without listeners
+		template <class TDelegate, class TNativeDelegate, class... TPayload> struct TEvent final : FEvent
+		{
+			template <class... TArgs>
+			TEvent(TDelegate& InDelegate, TNativeDelegate& InNativeDelegate, TArgs&&... Args)
+			    : Delegate(InDelegate), NativeDelegate(InNativeDelegate), Payload(Forward<TArgs>(Args)...)
+			{
+			}
+
+			void Broadcast() override
+			{
+				Payload.ApplyAfter(
+				    [this](const TPayload&... Args)
+				    {
+					    NativeDelegate.Broadcast(Args...);
+					    if (Delegate.IsBound())
+					    {
+						    Delegate.Broadcast(Args...);
+					    }
+				    });
+			}
+
+			TDelegate& Delegate;
+			TNativeDelegate& NativeDelegate;
+			TTuple<TPayload...> Payload;
+		};
+
+		// Large enough for the payloads of all events of the subsystem, bigger ones fall back to the heap
+		static constexpr int32 BlockSize = 256;
+		static constexpr int32 BlockAlignment = 16;
+		static constexpr int32 MaxLatestSlots = 4;
+
+		FLatestSlot* FindLatestSlot(const void* Delegate)
+		{
+			for (int32 i = 0; i < NumLatestSlots; ++i)
+			{
+				if (LatestSlots[i].Delegate == Delegate)
+				{
+					return &LatestSlots[i];
+				}
+			}
+			return nullptr;
+		}
+
+		void Push(FEvent* Event);
+		void Push(FLatestSlot& Slot, FEvent* Event);
+		void Broadcast(FEvent* Event);
+		void BroadcastQueued();
+		void Destroy(FEvent* Event);
+		bool Tick(float DeltaTime);
+
+		TFunction<void()> OnTick;
+
+		std::atomic<int32> NumPending{0};
+
+		// Pushed events, newest first
+		std::atomic<FEvent*> Head{nullptr};
+		// Events taken from Head but not broadcast yet because of the budget, oldest first. Game thread only.
+		FEvent* Pending = nullptr;
+		FEvent* PendingTail = nullptr;
+
+		FLatestSlot LatestSlots[MaxLatestSlots];
+		int32 NumLatestSlots = 0;
+
+		TLockFreeFixedSizeAllocator<BlockSize, PLATFORM_CACHE_LINE_SIZE> Arena;
+
+#if ENGINE_MAJOR_VERSION == 5
+		FTSTicker::FDelegateHandle TickerHandle;
+#else
+		FDelegateHandle TickerHandle;
+#endif
+	};
+}
@@ -0,0 +1,107 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "Utils/DolbyIOMemory.h"
+
+#include <cstdlib>
+#include <new>
+#if PLATFORM_MAC
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+LLM_DEFINE_TAG(DolbyIO);
+LLM_DEFINE_TAG(DolbyIO_VideoBuffers, TEXT("VideoBuffers"), TEXT("DolbyIO"));
+LLM_DEFINE_TAG(DolbyIO_VideoTextures, TEXT("VideoTextures"), TEXT("DolbyIO"));
+LLM_DEFINE_TAG(DolbyIO_Sdk, TEXT("SDK"), TEXT("DolbyIO"));
+LLM_DEFINE_TAG(DolbyIO_Events, TEXT("Events"), TEXT("DolbyIO"));
+
+namespace DolbyIO
+{
+	namespace
+	{
+		constexpr std::size_t DefaultAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+		FSdkMemoryCounters SdkCounters;
+
+		// Sizes are counted with the usable size the C runtime reports instead of a header, so that blocks stay
+		// compatible with the default heap and the SDK can free through the allocator what it allocated before it was
+		// installed
+		std::size_t GetUsableSize(void* Ptr, std::size_t Alignment)
+		{
+#if PLATFORM_WINDOWS
+			return Alignment > DefaultAlignment ? _aligned_msize(Ptr, Alignment, 0) : _msize(Ptr);
+#elif PLATFORM_MAC
+			return malloc_size(Ptr);
+#elif PLATFORM_LINUX || PLATFORM_ANDROID
+			return malloc_usable_size(Ptr);
+#else
+			return 0;
+#endif
+		}
+
+		void* Allocate(std::size_t Count, std::size_t Alignment)
+		{
+			LLM_SCOPE_BYTAG(DolbyIO_Sdk);
+#if PLATFORM_WINDOWS
+			void* Ptr = Alignment > DefaultAlignment ? _aligned_malloc(Count, Alignment) : malloc(Count);
+#else
+			void* Ptr = nullptr;
+			if (Alignment > DefaultAlignment)
+			{
+				if (posix_memalign(&Ptr, Alignment, Count))
+				{
+					Ptr = nullptr;
+				}
+			}
+			else
+			{
+				Ptr = malloc(Count);
+			}
+#endif
+			if (!Ptr)
+			{
+				throw std::bad_alloc{}; // like the operator new the SDK would use otherwise
+			}
+			const std::size_t Size = GetUsableSize(Ptr, Alignment);
+			LLM(FLowLevelMemTracker::Get().OnLowLevelAlloc(ELLMTracker::Default, Ptr, Size));
+			SdkCounters.Bytes += Size;
+			++SdkCounters.Allocations;
+			return Ptr;
+		}
+
+		// Blocks allocated before the allocator was installed are subtracted without having been added, so the counters
+		// are approximate and clamped when read
+		void Free(void* Ptr, std::size_t Alignment)
+		{
+			if (!Ptr)
+			{
+				return;
+			}
+			LLM(FLowLevelMemTracker::Get().OnLowLevelFree(ELLMTracker::Default, Ptr));
+			SdkCounters.Bytes -= GetUsableSize(Ptr, Alignment);
+			--SdkCounters.Allocations;
+#if PLATFORM_WINDOWS
+			if (Alignment > DefaultAlignment)
+			{
+				_aligned_free(Ptr);
+				return;
+			}
+#endif
+			free(Ptr);
+		}
+	}
+
+	dolbyio::comms::app_allocator GetSdkAllocator()
+	{
+		return {[](std::size_t Count) { return Allocate(Count, DefaultAlignment); },
+		        [](std::size_t Count, std::size_t Alignment) { return Allocate(Count, Alignment); },
+		        [](void* Ptr) { Free(Ptr, DefaultAlignment); },
+		        [](void* Ptr, std::size_t Alignment) { Free(Ptr, Alignment); }};
+	}
+
+	const FSdkMemoryCounters& GetSdkMemoryCounters()
+	{
+		return SdkCounters;
+	}
+}
@@ -0,0 +1,46 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "Utils/DolbyIOCppSdk.h"
+
+#include "HAL/LowLevelMemTracker.h"
+#include "Math/UnrealMathUtility.h"
+
+#include <atomic>
+
+// Low-Level Memory tracker tags of the plugin, reported under DolbyIO when running with -llm
+LLM_DECLARE_TAG(DolbyIO);
+// Frame buffers of video tracks, written by the thread delivering frames and read by the render thread
+LLM_DECLARE_TAG(DolbyIO_VideoBuffers);
+// Textures of video tracks, including the pooled ones
+LLM_DECLARE_TAG(DolbyIO_VideoTextures);
+// Heap of the SDK and the video processor, allocated through GetSdkAllocator
+LLM_DECLARE_TAG(DolbyIO_Sdk);
+// Participant and track bookkeeping done by event handlers, and event payloads waiting to be broadcast
+LLM_DECLARE_TAG(DolbyIO_Events);
+
+namespace DolbyIO
+{
+	struct FSdkMemoryCounters
+	{
+		std::atomic<int64> Bytes{0};
+		std::atomic<int64> Allocations{0};
+
+		// The raw counts go below zero when the SDK frees blocks it allocated before the allocator was installed
+		int64 GetBytes() const
+		{
+			return FMath::Max<int64>(Bytes, 0);
+		}
+		int64 GetAllocations() const
+		{
+			return FMath::Max<int64>(Allocations, 0);
+		}
+	};
+
+	// Allocator to install with set_app_allocator. Allocates from the C runtime heap like the SDK's default one, and
+	// attributes the blocks to the DolbyIO_Sdk tag and counts them in GetSdkMemoryCounters.
+	dolbyio::comms::app_allocator GetSdkAllocator();
+	// Usable memory currently allocated through GetSdkAllocator
+	const FSdkMemoryCounters& GetSdkMemoryCounters();
+}
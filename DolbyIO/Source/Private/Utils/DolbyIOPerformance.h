@@ -0,0 +1,52 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "HAL/Platform.h"
+
+#include <atomic>
+
+namespace DolbyIO
+{
+	// Turns an ever increasing count into a per second rate which is refreshed at most once per window, so that it can
+	// be polled every frame. Must be used on one thread only.
+	class FRateMeter final
+	{
+	public:
+		double Update(uint64 Count, double Now)
+		{
+			if (WindowStart < 0.0)
+			{
+				WindowStart = Now;
+				WindowCount = Count;
+			}
+			else if (Now - WindowStart >= Window)
+			{
+				Rate = (Count - WindowCount) / (Now - WindowStart);
+				WindowStart = Now;
+				WindowCount = Count;
+			}
+			return Rate;
+		}
+
+	private:
+		static constexpr double Window = 1.0;
+
+		double WindowStart = -1.0;
+		uint64 WindowCount = 0;
+		double Rate = 0.0;
+	};
+
+	// What the subsystem reports in its performance snapshot besides video tracks. The counts may be incremented from
+	// any thread, the rates are computed on the game thread.
+	struct FPerformanceCounters final
+	{
+		std::atomic<uint64> SpatialUpdates{0};
+		std::atomic<uint64> MessagesSent{0};
+		std::atomic<uint64> MessagesReceived{0};
+
+		FRateMeter SpatialUpdateRate;
+		FRateMeter MessageSendRate;
+		FRateMeter MessageReceiveRate;
+	};
+}
@@ -0,0 +1,94 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "Utils/DolbyIOTrace.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/PlatformTime.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+#include <atomic>
+
+UE_TRACE_CHANNEL_DEFINE(DolbyIOChannel);
+
+TRACE_DECLARE_INT_COUNTER(DolbyIO_HandledEvents, TEXT("DolbyIO/Handled events"));
+TRACE_DECLARE_INT_COUNTER(DolbyIO_PendingBroadcasts, TEXT("DolbyIO/Pending broadcasts"));
+TRACE_DECLARE_INT_COUNTER(DolbyIO_Errors, TEXT("DolbyIO/Errors"));
+TRACE_DECLARE_INT_COUNTER(DolbyIO_VideoFrames, TEXT("DolbyIO/Video frames"));
+
+UE_TRACE_EVENT_BEGIN(DolbyIO, BroadcastQueued)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, BroadcastID)
+	UE_TRACE_EVENT_FIELD(uint32, ThreadID)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(DolbyIO, BroadcastDispatched)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, BroadcastID)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(DolbyIO, BroadcastDropped)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(uint32, BroadcastID)
+UE_TRACE_EVENT_END()
+
+namespace DolbyIO
+{
+	namespace
+	{
+		std::atomic<uint32> NextBroadcastID{1};
+
+		TAutoConsoleVariable<bool> CVarBroadcastBookmarks{
+		    TEXT("DolbyIO.Trace.BroadcastBookmarks"), false,
+		    TEXT("If true and the DolbyIO trace channel is enabled, every broadcast is also marked by a bookmark when "
+		         "it is queued and when it is dispatched. Only meant for short captures, since bookmarks crowd the "
+		         "timing view and add to the latency they measure.")};
+	}
+
+	uint32 TraceBroadcastQueued()
+	{
+		if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(DolbyIOChannel))
+		{
+			return 0;
+		}
+
+		const uint32 BroadcastID = NextBroadcastID++;
+		TRACE_COUNTER_INCREMENT(DolbyIO_PendingBroadcasts);
+		UE_TRACE_LOG(DolbyIO, BroadcastQueued, DolbyIOChannel)
+		    << BroadcastQueued.Cycle(FPlatformTime::Cycles64()) << BroadcastQueued.BroadcastID(BroadcastID)
+		    << BroadcastQueued.ThreadID(FPlatformTLS::GetCurrentThreadId());
+		if (CVarBroadcastBookmarks.GetValueOnAnyThread())
+		{
+			TRACE_BOOKMARK(TEXT("DolbyIO broadcast %u queued"), BroadcastID);
+		}
+		return BroadcastID;
+	}
+
+	void TraceBroadcastDispatched(uint32 BroadcastID)
+	{
+		if (!BroadcastID)
+		{
+			return;
+		}
+
+		TRACE_COUNTER_DECREMENT(DolbyIO_PendingBroadcasts);
+		UE_TRACE_LOG(DolbyIO, BroadcastDispatched, DolbyIOChannel)
+		    << BroadcastDispatched.Cycle(FPlatformTime::Cycles64()) << BroadcastDispatched.BroadcastID(BroadcastID);
+		if (CVarBroadcastBookmarks.GetValueOnAnyThread())
+		{
+			TRACE_BOOKMARK(TEXT("DolbyIO broadcast %u dispatched"), BroadcastID);
+		}
+	}
+
+	void TraceBroadcastDropped(uint32 BroadcastID)
+	{
+		if (!BroadcastID)
+		{
+			return;
+		}
+
+		TRACE_COUNTER_DECREMENT(DolbyIO_PendingBroadcasts);
+		UE_TRACE_LOG(DolbyIO, BroadcastDropped, DolbyIOChannel)
+		    << BroadcastDropped.Cycle(FPlatformTime::Cycles64()) << BroadcastDropped.BroadcastID(BroadcastID);
+	}
+}
@@ -0,0 +1,40 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "Utils/DolbyIOMemory.h"
+
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+// Unreal Insights channel of the plugin, enabled with -trace=default,DolbyIO or the Trace.Enable DolbyIO command
+UE_TRACE_CHANNEL_EXTERN(DolbyIOChannel);
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(DolbyIO_HandledEvents);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DolbyIO_PendingBroadcasts);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DolbyIO_Errors);
+TRACE_DECLARE_INT_COUNTER_EXTERN(DolbyIO_VideoFrames);
+
+#define DLB_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("DolbyIO::" Name, DolbyIOChannel)
+
+// To be used at the top of every function called by the SDK with an event, also attributes what the handler allocates
+// to the DolbyIO_Events LLM tag
+#define DLB_TRACE_HANDLER(Name)                     \
+	DLB_TRACE_SCOPE(Name);                          \
+	TRACE_COUNTER_INCREMENT(DolbyIO_HandledEvents); \
+	LLM_SCOPE_BYTAG(DolbyIO_Events)
+
+namespace DolbyIO
+{
+	// Every broadcast is traced as a BroadcastQueued event on the thread which handled the SDK event and a
+	// BroadcastDispatched event on the game thread, both in the DolbyIO logger and carrying the same ID, so that the
+	// latency between the two can be read from the trace. The handler and the broadcast themselves show up as CPU
+	// scopes. Unreal Insights has no analyzer for the logger events, so with DolbyIO.Trace.BroadcastBookmarks set both
+	// are also traced as bookmarks named after the ID, which the timing view shows. Returns 0 if the channel is
+	// disabled.
+	uint32 TraceBroadcastQueued();
+	void TraceBroadcastDispatched(uint32 BroadcastID);
+	// For coalesced events replaced by a newer one before being broadcast, traced as a BroadcastDropped event only
+	void TraceBroadcastDropped(uint32 BroadcastID);
+}
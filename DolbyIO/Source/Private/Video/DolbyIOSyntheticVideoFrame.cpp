@@ -0,0 +1,354 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOSyntheticVideoFrame.h"
+
+#include "DolbyIOVideoPlanes.h"
+
+namespace DolbyIO
+{
+	using namespace dolbyio::comms;
+
+	namespace
+	{
+		// A diagonal gradient with a bar whose position depends on the sequence number
+		void FillPlane(uint8* Plane, int RowBytes, int Rows, uint32 SequenceNumber)
+		{
+			const int BarColumn = (SequenceNumber * 8) % FMath::Max(RowBytes, 1);
+			for (int Row = 0; Row < Rows; ++Row)
+			{
+				uint8* Data = Plane + Row * RowBytes;
+				for (int Column = 0; Column < RowBytes; ++Column)
+				{
+					Data[Column] = static_cast<uint8>(Row + Column);
+				}
+				FMemory::Memset(Data + BarColumn, 235, FMath::Min(8, RowBytes - BarColumn));
+			}
+		}
+
+		class FI420Buffer final : public video_frame_buffer_i420_interface,
+		                          public std::enable_shared_from_this<FI420Buffer>
+		{
+		public:
+			FI420Buffer(int Width, int Height, TArray<uint8>&& Data)
+			    : Width(Width), Height(Height), ChromaWidth(GetChromaSize(Width)), Data(MoveTemp(Data))
+			{
+			}
+
+			static TArray<uint8> Generate(int Width, int Height, uint32 SequenceNumber)
+			{
+				const int ChromaWidth = GetChromaSize(Width);
+				const int ChromaHeight = GetChromaSize(Height);
+				TArray<uint8> Ret;
+				Ret.SetNumUninitialized(GetPackedVideoFrameSize(ESyntheticVideoFormat::I420, Width, Height));
+				uint8* U = Ret.GetData() + Width * Height;
+				FillPlane(Ret.GetData(), Width, Height, SequenceNumber);
+				FillPlane(U, ChromaWidth, ChromaHeight, SequenceNumber);
+				FillPlane(U + ChromaWidth * ChromaHeight, ChromaWidth, ChromaHeight, SequenceNumber + 1);
+				return Ret;
+			}
+
+			enum video_frame_buffer::type type() const override
+			{
+				return video_frame_buffer::type::i420;
+			}
+			int width() const override
+			{
+				return Width;
+			}
+			int height() const override
+			{
+				return Height;
+			}
+			std::shared_ptr<video_frame_buffer_i420_interface> to_i420() override
+			{
+				return shared_from_this();
+			}
+			const video_frame_buffer_i420_interface* get_i420() const override
+			{
+				return this;
+			}
+
+			const uint8_t* data_y() const override
+			{
+				return Data.GetData();
+			}
+			const uint8_t* data_u() const override
+			{
+				return data_y() + Width * Height;
+			}
+			const uint8_t* data_v() const override
+			{
+				return data_u() + ChromaWidth * GetChromaSize(Height);
+			}
+			int stride_y() const override
+			{
+				return Width;
+			}
+			int stride_u() const override
+			{
+				return ChromaWidth;
+			}
+			int stride_v() const override
+			{
+				return ChromaWidth;
+			}
+
+		private:
+			const int Width;
+			const int Height;
+			const int ChromaWidth;
+			const TArray<uint8> Data;
+		};
+
+		class FNV12Buffer final : public video_frame_buffer_nv12_interface
+		{
+		public:
+			FNV12Buffer(int Width, int Height, TArray<uint8>&& Data)
+			    : Width(Width), Height(Height), ChromaStride(GetChromaSize(Width) * 2), Data(MoveTemp(Data))
+			{
+			}
+
+			static TArray<uint8> Generate(int Width, int Height, uint32 SequenceNumber)
+			{
+				TArray<uint8> Ret;
+				Ret.SetNumUninitialized(GetPackedVideoFrameSize(ESyntheticVideoFormat::NV12, Width, Height));
+				FillPlane(Ret.GetData(), Width, Height, SequenceNumber);
+				FillPlane(Ret.GetData() + Width * Height, GetChromaSize(Width) * 2, GetChromaSize(Height),
+				          SequenceNumber);
+				return Ret;
+			}
+
+			enum video_frame_buffer::type type() const override
+			{
+				return video_frame_buffer::type::nv12;
+			}
+			int width() const override
+			{
+				return Width;
+			}
+			int height() const override
+			{
+				return Height;
+			}
+			std::shared_ptr<video_frame_buffer_i420_interface> to_i420() override
+			{
+				return nullptr;
+			}
+			const video_frame_buffer_nv12_interface* get_nv12() const override
+			{
+				return this;
+			}
+
+			const uint8_t* data_y() const override
+			{
+				return Data.GetData();
+			}
+			const uint8_t* data_uv() const override
+			{
+				return data_y() + Width * Height;
+			}
+			int stride_y() const override
+			{
+				return Width;
+			}
+			int stride_uv() const override
+			{
+				return ChromaStride;
+			}
+
+		private:
+			const int Width;
+			const int Height;
+			const int ChromaStride;
+			const TArray<uint8> Data;
+		};
+
+		class FArgbBuffer final : public video_frame_buffer_argb_interface
+		{
+		public:
+			FArgbBuffer(int Width, int Height, TArray<uint8>&& Data)
+			    : Width(Width), Height(Height), Data(MoveTemp(Data))
+			{
+			}
+
+			static TArray<uint8> Generate(int Width, int Height, uint32 SequenceNumber)
+			{
+				TArray<uint8> Ret;
+				Ret.SetNumUninitialized(GetPackedVideoFrameSize(ESyntheticVideoFormat::Argb, Width, Height));
+				FillPlane(Ret.GetData(), Width * 4, Height, SequenceNumber);
+				return Ret;
+			}
+
+			enum video_frame_buffer::type type() const override
+			{
+				return video_frame_buffer::type::argb;
+			}
+			int width() const override
+			{
+				return Width;
+			}
+			int height() const override
+			{
+				return Height;
+			}
+			std::shared_ptr<video_frame_buffer_i420_interface> to_i420() override
+			{
+				return nullptr;
+			}
+			const video_frame_buffer_argb_interface* get_argb() const override
+			{
+				return this;
+			}
+
+			const uint8_t* data() const override
+			{
+				return Data.GetData();
+			}
+			int stride() const override
+			{
+				return Width * 4;
+			}
+
+		private:
+			const int Width;
+			const int Height;
+			const TArray<uint8> Data;
+		};
+
+		std::shared_ptr<video_frame_buffer> MakeBuffer(ESyntheticVideoFormat Format, int Width, int Height,
+		                                               TArray<uint8>&& Data)
+		{
+			switch (Format)
+			{
+				case ESyntheticVideoFormat::I420:
+					return std::make_shared<FI420Buffer>(Width, Height, MoveTemp(Data));
+				case ESyntheticVideoFormat::NV12:
+					return std::make_shared<FNV12Buffer>(Width, Height, MoveTemp(Data));
+				default:
+					return std::make_shared<FArgbBuffer>(Width, Height, MoveTemp(Data));
+			}
+		}
+	}
+
+	bool ParseSyntheticVideoFormat(const FString& String, ESyntheticVideoFormat& OutFormat)
+	{
+		for (ESyntheticVideoFormat Format :
+		     {ESyntheticVideoFormat::I420, ESyntheticVideoFormat::NV12, ESyntheticVideoFormat::Argb})
+		{
+			if (String.Equals(ToString(Format), ESearchCase::IgnoreCase))
+			{
+				OutFormat = Format;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const TCHAR* ToString(ESyntheticVideoFormat Format)
+	{
+		switch (Format)
+		{
+			case ESyntheticVideoFormat::I420:
+				return TEXT("I420");
+			case ESyntheticVideoFormat::NV12:
+				return TEXT("NV12");
+			default:
+				return TEXT("ARGB");
+		}
+	}
+
+	int GetPackedVideoFrameSize(ESyntheticVideoFormat Format, int Width, int Height)
+	{
+		return Format == ESyntheticVideoFormat::Argb ? Width * 4 * Height : GetPlanarFrameSize(Width, Height);
+	}
+
+	bool PackVideoFrame(const video_frame& VideoFrame, ESyntheticVideoFormat& OutFormat, TArray<uint8>& OutData)
+	{
+		std::shared_ptr<video_frame_buffer> Buffer = VideoFrame.video_frame_buffer();
+		if (!Buffer)
+		{
+			return false;
+		}
+
+		const int Width = VideoFrame.width();
+		const int Height = VideoFrame.height();
+		const int ChromaWidth = GetChromaSize(Width);
+		const int ChromaHeight = GetChromaSize(Height);
+		if (const video_frame_buffer_i420_interface* I420 = Buffer->get_i420())
+		{
+			OutFormat = ESyntheticVideoFormat::I420;
+			OutData.SetNumUninitialized(GetPackedVideoFrameSize(OutFormat, Width, Height));
+			uint8* U = OutData.GetData() + Width * Height;
+			uint8* V = U + ChromaWidth * ChromaHeight;
+			CopyPlane(I420->data_y(), I420->stride_y(), OutData.GetData(), Width, Width, Height);
+			CopyPlane(I420->data_u(), I420->stride_u(), U, ChromaWidth, ChromaWidth, ChromaHeight);
+			CopyPlane(I420->data_v(), I420->stride_v(), V, ChromaWidth, ChromaWidth, ChromaHeight);
+			return true;
+		}
+		if (const video_frame_buffer_nv12_interface* NV12 = Buffer->get_nv12())
+		{
+			OutFormat = ESyntheticVideoFormat::NV12;
+			OutData.SetNumUninitialized(GetPackedVideoFrameSize(OutFormat, Width, Height));
+			PackNV12(NV12->data_y(), NV12->stride_y(), NV12->data_uv(), NV12->stride_uv(), OutData.GetData(), Width,
+			         Height);
+			return true;
+		}
+		if (const video_frame_buffer_argb_interface* Argb = Buffer->get_argb())
+		{
+			OutFormat = ESyntheticVideoFormat::Argb;
+			OutData.SetNumUninitialized(GetPackedVideoFrameSize(OutFormat, Width, Height));
+			CopyPlane(Argb->data(), Argb->stride(), OutData.GetData(), Width * 4, Width * 4, Height);
+			return true;
+		}
+		return false;
+	}
+
+	FSyntheticVideoFrame::FSyntheticVideoFrame(ESyntheticVideoFormat Format, int Width, int Height,
+	                                           uint32 SequenceNumber)
+	    : Width(Width), Height(Height)
+	{
+		switch (Format)
+		{
+			case ESyntheticVideoFormat::I420:
+				Buffer = MakeBuffer(Format, Width, Height, FI420Buffer::Generate(Width, Height, SequenceNumber));
+				break;
+			case ESyntheticVideoFormat::NV12:
+				Buffer = MakeBuffer(Format, Width, Height, FNV12Buffer::Generate(Width, Height, SequenceNumber));
+				break;
+			default:
+				Buffer = MakeBuffer(Format, Width, Height, FArgbBuffer::Generate(Width, Height, SequenceNumber));
+				break;
+		}
+	}
+
+	FSyntheticVideoFrame::FSyntheticVideoFrame(ESyntheticVideoFormat Format, int Width, int Height,
+	                                           TArray<uint8>&& PackedData)
+	    : Buffer(MakeBuffer(Format, Width, Height, MoveTemp(PackedData))), Width(Width), Height(Height)
+	{
+	}
+
+	int FSyntheticVideoFrame::width() const
+	{
+		return Width;
+	}
+
+	int FSyntheticVideoFrame::height() const
+	{
+		return Height;
+	}
+
+	int64_t FSyntheticVideoFrame::timestamp_us() const
+	{
+		return TimestampUs;
+	}
+
+	std::shared_ptr<video_frame_buffer> FSyntheticVideoFrame::video_frame_buffer() const
+	{
+		return Buffer;
+	}
+
+	void FSyntheticVideoFrame::SetTimestamp(int64 InTimestampUs)
+	{
+		TimestampUs = InTimestampUs;
+	}
+}
@@ -0,0 +1,50 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "Utils/DolbyIOCppSdk.h"
+
+#include "Containers/Array.h"
+#include "Containers/UnrealString.h"
+
+namespace DolbyIO
+{
+	enum class ESyntheticVideoFormat
+	{
+		I420,
+		NV12,
+		Argb,
+	};
+
+	bool ParseSyntheticVideoFormat(const FString& String, ESyntheticVideoFormat& OutFormat);
+	const TCHAR* ToString(ESyntheticVideoFormat Format);
+
+	// Size of a frame whose planes directly follow each other without padding: Y, U and V for I420, Y and UV for NV12.
+	int GetPackedVideoFrameSize(ESyntheticVideoFormat Format, int Width, int Height);
+	// Copies the planes of any frame delivered by the SDK to the packed layout. Returns false for native frames.
+	bool PackVideoFrame(const dolbyio::comms::video_frame& VideoFrame, ESyntheticVideoFormat& OutFormat,
+	                    TArray<uint8>& OutData);
+
+	// A video frame generated in memory, used to drive the video path without a conference. Frames created with
+	// different sequence numbers differ in content so that they are not detected as identical.
+	class FSyntheticVideoFrame final : public dolbyio::comms::video_frame
+	{
+	public:
+		FSyntheticVideoFrame(ESyntheticVideoFormat Format, int Width, int Height, uint32 SequenceNumber);
+		// Wraps the packed planes of a previously captured frame
+		FSyntheticVideoFrame(ESyntheticVideoFormat Format, int Width, int Height, TArray<uint8>&& PackedData);
+
+		int width() const override;
+		int height() const override;
+		int64_t timestamp_us() const override;
+		std::shared_ptr<dolbyio::comms::video_frame_buffer> video_frame_buffer() const override;
+
+		void SetTimestamp(int64 TimestampUs);
+
+	private:
+		std::shared_ptr<dolbyio::comms::video_frame_buffer> Buffer;
+		const int Width;
+		const int Height;
+		int64 TimestampUs = 0;
+	};
+}
@@ -0,0 +1,278 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOVideoBenchmarkCommandlet.h"
+
+#include "DolbyIOSyntheticVideoFrame.h"
+#include "DolbyIOVideoSink.h"
+#include "Utils/DolbyIOLogging.h"
+
+#include "Async/Async.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "RenderingThread.h"
+
+namespace DolbyIO
+{
+	namespace
+	{
+		// Frames cycle through this many variants so that they are not detected as identical to the previous one
+		constexpr int NumFrameVariants = 4;
+		// How often the game thread runs its queued tasks, similar to a game running at 60 fps
+		constexpr float GameThreadTickSeconds = 1.f / 60;
+
+		struct FBenchmarkCase
+		{
+			ESyntheticVideoFormat Format;
+			int Width;
+			int Height;
+			int Tracks;
+		};
+
+		struct FBenchmarkResult
+		{
+			uint64 DeliveredFrames = 0;
+			double DeliverySeconds = 0;
+			TArray<double> HandleFrameMs;
+			uint64 ReceivedFrames = 0;
+			uint64 CoalescedFrames = 0;
+			uint64 DroppedFrames = 0;
+			uint64 SkippedFrames = 0;
+			uint64 ConversionCycles = 0;
+			uint64 HandOffCycles = 0;
+			double GameThreadMs = 0;
+			int GameThreadTicks = 0;
+		};
+
+		template <typename T, typename TParse>
+		TArray<T> ParseList(const FString& Params, const TCHAR* Name, const TCHAR* Default, TParse&& Parse)
+		{
+			FString Value;
+			if (!FParse::Value(*Params, Name, Value, false))
+			{
+				Value = Default;
+			}
+
+			TArray<FString> Items;
+			Value.ParseIntoArray(Items, TEXT(","));
+			TArray<T> Ret;
+			for (const FString& Item : Items)
+			{
+				T Parsed;
+				if (Parse(Item.TrimStartAndEnd(), Parsed))
+				{
+					Ret.Add(Parsed);
+				}
+				else
+				{
+					DLB_UE_LOG_BASE(Warning, "Ignoring invalid %s%s", Name, *Item);
+				}
+			}
+			return Ret;
+		}
+
+		bool ParseResolution(const FString& String, FIntPoint& OutResolution)
+		{
+			FString Width, Height;
+			if (!String.Split(TEXT("x"), &Width, &Height, ESearchCase::IgnoreCase))
+			{
+				return false;
+			}
+			OutResolution = {FCString::Atoi(*Width), FCString::Atoi(*Height)};
+			return OutResolution.X > 0 && OutResolution.Y > 0;
+		}
+
+		bool ParseTrackCount(const FString& String, int& OutTracks)
+		{
+			OutTracks = FCString::Atoi(*String);
+			return OutTracks > 0;
+		}
+
+		double GetPercentile(TArray<double> Values, double Percentile)
+		{
+			if (!Values.Num())
+			{
+				return 0;
+			}
+			Values.Sort();
+			return Values[FMath::Min(Values.Num() - 1, FMath::FloorToInt(Values.Num() * Percentile))];
+		}
+
+		FBenchmarkResult Run(const FBenchmarkCase& Case, int Fps, double Seconds)
+		{
+			using namespace dolbyio::comms;
+
+			TArray<std::shared_ptr<FSyntheticVideoFrame>> Frames;
+			for (int i = 0; i < NumFrameVariants; ++i)
+			{
+				Frames.Add(std::make_shared<FSyntheticVideoFrame>(Case.Format, Case.Width, Case.Height, i));
+			}
+
+			TArray<std::shared_ptr<FVideoSink>> Sinks;
+			for (int i = 0; i < Case.Tracks; ++i)
+			{
+				Sinks.Add(std::make_shared<FVideoSink>(FString::Printf(TEXT("Benchmark%d"), i)));
+			}
+
+			FBenchmarkResult Result;
+			std::atomic<bool> bIsDelivering{true};
+
+			// The SDK delivers the frames of all tracks on a single thread, so do we
+			TFuture<void> Delivery = Async(
+			    EAsyncExecution::Thread,
+			    [&]
+			    {
+				    const double FrameInterval = 1.0 / Fps;
+				    const double Start = FPlatformTime::Seconds();
+				    for (int FrameIndex = 0;; ++FrameIndex)
+				    {
+					    const double Deadline = Start + FrameIndex * FrameInterval;
+					    if (Deadline - Start >= Seconds)
+					    {
+						    break;
+					    }
+					    const double Now = FPlatformTime::Seconds();
+					    if (Deadline > Now)
+					    {
+						    FPlatformProcess::Sleep(Deadline - Now);
+					    }
+
+					    FSyntheticVideoFrame& Frame = *Frames[FrameIndex % NumFrameVariants];
+					    Frame.SetTimestamp(FrameIndex * 1000000ll / Fps);
+					    for (const std::shared_ptr<FVideoSink>& Sink : Sinks)
+					    {
+						    const uint64 HandleStart = FPlatformTime::Cycles64();
+						    static_cast<video_sink&>(*Sink).handle_frame(Frame);
+						    const uint64 HandleEnd = FPlatformTime::Cycles64();
+						    Result.HandleFrameMs.Add(FPlatformTime::ToMilliseconds64(HandleEnd - HandleStart));
+						    ++Result.DeliveredFrames;
+					    }
+				    }
+				    Result.DeliverySeconds = FPlatformTime::Seconds() - Start;
+				    bIsDelivering = false;
+			    });
+
+			// Texture creation and render requests are posted to the game thread, which is this one
+			while (bIsDelivering)
+			{
+				const double TickStart = FPlatformTime::Seconds();
+				FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+				Result.GameThreadMs += (FPlatformTime::Seconds() - TickStart) * 1000.0;
+				++Result.GameThreadTicks;
+				FPlatformProcess::Sleep(GameThreadTickSeconds);
+			}
+			Delivery.Wait();
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FlushRenderingCommands();
+
+			for (const std::shared_ptr<FVideoSink>& Sink : Sinks)
+			{
+				const FVideoSink::FCounters& Counters = Sink->GetCounters();
+				Result.ReceivedFrames += Counters.ReceivedFrames;
+				Result.CoalescedFrames += Counters.CoalescedFrames;
+				Result.DroppedFrames += Counters.DroppedFrames;
+				Result.SkippedFrames += Counters.SkippedFrames;
+				Result.ConversionCycles += Counters.ConversionCycles;
+				Result.HandOffCycles += Counters.HandOffCycles;
+				Sink->Disable();
+			}
+			Sinks.Empty();
+
+			// Let the textures go back to the pool before the next case
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FlushRenderingCommands();
+			return Result;
+		}
+
+		FString ToCsvRow(const FBenchmarkCase& Case, int Fps, const FBenchmarkResult& Result)
+		{
+			const uint64 ConvertedFrames = FMath::Max<uint64>(
+			    Result.ReceivedFrames - Result.DroppedFrames - Result.SkippedFrames, 1);
+			double HandleFrameTotalMs = 0;
+			for (double Ms : Result.HandleFrameMs)
+			{
+				HandleFrameTotalMs += Ms;
+			}
+			return FString::Printf(
+			    TEXT("%s,%d,%d,%d,%d,%.2f,%llu,%llu,%llu,%llu,%.3f,%.3f,%.3f,%.4f,%.3f"), ToString(Case.Format),
+			    Case.Width, Case.Height, Case.Tracks, Fps,
+			    Result.DeliverySeconds > 0 ? Result.DeliveredFrames / Result.DeliverySeconds / Case.Tracks : 0.0,
+			    Result.ReceivedFrames, Result.CoalescedFrames, Result.DroppedFrames, Result.SkippedFrames,
+			    Result.HandleFrameMs.Num() ? HandleFrameTotalMs / Result.HandleFrameMs.Num() : 0.0,
+			    GetPercentile(Result.HandleFrameMs, 0.99),
+			    FPlatformTime::ToMilliseconds64(Result.ConversionCycles) / ConvertedFrames,
+			    FPlatformTime::ToMilliseconds64(Result.HandOffCycles) / ConvertedFrames,
+			    Result.GameThreadTicks ? Result.GameThreadMs / Result.GameThreadTicks : 0.0);
+		}
+
+		const TCHAR* CsvHeader = TEXT("Format,Width,Height,Tracks,TargetFps,DeliveredFpsPerTrack,ReceivedFrames,"
+		                              "CoalescedFrames,DroppedFrames,SkippedFrames,HandleFrameAvgMs,HandleFrameP99Ms,"
+		                              "ConversionAvgMs,HandOffAvgMs,GameThreadPerTickMs");
+	}
+}
+
+UDolbyIOVideoBenchmarkCommandlet::UDolbyIOVideoBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UDolbyIOVideoBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace DolbyIO;
+
+	const TArray<ESyntheticVideoFormat> Formats =
+	    ParseList<ESyntheticVideoFormat>(Params, TEXT("Formats="), TEXT("I420,NV12,ARGB"), &ParseSyntheticVideoFormat);
+	const TArray<FIntPoint> Resolutions =
+	    ParseList<FIntPoint>(Params, TEXT("Resolutions="), TEXT("1280x720,1920x1080"), &ParseResolution);
+	const TArray<int> TrackCounts = ParseList<int>(Params, TEXT("Tracks="), TEXT("1,4,16"), &ParseTrackCount);
+	int Fps = 30;
+	FParse::Value(*Params, TEXT("Fps="), Fps);
+	float Seconds = 5.f;
+	FParse::Value(*Params, TEXT("Seconds="), Seconds);
+	FString CsvPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("DolbyIO"), TEXT("VideoBenchmark.csv"));
+	FParse::Value(*Params, TEXT("Csv="), CsvPath);
+
+	if (!Formats.Num() || !Resolutions.Num() || !TrackCounts.Num() || Fps <= 0 || Seconds <= 0)
+	{
+		DLB_UE_LOG_BASE(Error, "Usage: -run=DolbyIOVideoBenchmark [-Formats=I420,NV12,ARGB] "
+		                       "[-Resolutions=1280x720,1920x1080] [-Tracks=1,4,16] [-Fps=30] [-Seconds=5] [-Csv=path]");
+		return 1;
+	}
+
+	// Append to an existing file so that results of several plugin versions can be compared side by side
+	TArray<FString> Rows;
+	if (!IFileManager::Get().FileExists(*CsvPath))
+	{
+		Rows.Add(CsvHeader);
+	}
+	for (ESyntheticVideoFormat Format : Formats)
+	{
+		for (const FIntPoint& Resolution : Resolutions)
+		{
+			for (int Tracks : TrackCounts)
+			{
+				const FBenchmarkCase Case{Format, Resolution.X, Resolution.Y, Tracks};
+				DLB_UE_LOG("Benchmarking %s %dx%d, %d tracks at %d fps for %.1f s", ToString(Format), Resolution.X,
+				           Resolution.Y, Tracks, Fps, Seconds);
+				Rows.Add(ToCsvRow(Case, Fps, Run(Case, Fps, Seconds)));
+				DLB_UE_LOG("%s", *Rows.Last());
+			}
+		}
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Rows, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect,
+	                                        &IFileManager::Get(), FILEWRITE_Append))
+	{
+		DLB_UE_LOG_BASE(Error, "Could not write %s", *CsvPath);
+		return 1;
+	}
+	DLB_UE_LOG("Results written to %s", *CsvPath);
+	return 0;
+}
@@ -0,0 +1,23 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "Commandlets/Commandlet.h"
+
+#include "DolbyIOVideoBenchmarkCommandlet.generated.h"
+
+/** Pushes synthetic video frames through the plugin's video path without a conference and reports the cost as CSV.
+ *
+ * UnrealEditor-Cmd <Project> -run=DolbyIOVideoBenchmark -nullrhi [-Formats=I420,NV12,ARGB]
+ * [-Resolutions=1280x720,1920x1080] [-Tracks=1,4,16] [-Fps=30] [-Seconds=5] [-Csv=<path>]
+ */
+UCLASS()
+class UDolbyIOVideoBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UDolbyIOVideoBenchmarkCommandlet();
+
+	int32 Main(const FString& Params) override;
+};
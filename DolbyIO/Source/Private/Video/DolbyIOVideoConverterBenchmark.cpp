@@ -0,0 +1,134 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOVideoConverters.h"
+#include "Utils/DolbyIOLogging.h"
+
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+namespace DolbyIO
+{
+	namespace
+	{
+		struct FSyntheticFrame
+		{
+			FSyntheticFrame(int Width, int Height)
+			    : Width(Width), Height(Height), ChromaWidth((Width + 1) / 2), ChromaHeight((Height + 1) / 2)
+			{
+				FRandomStream Random{Width * Height};
+				auto Fill = [&Random](TArray<uint8>& Plane, int Size)
+				{
+					Plane.SetNumUninitialized(Size);
+					for (uint8& Byte : Plane)
+					{
+						Byte = static_cast<uint8>(Random.RandHelper(256));
+					}
+				};
+				Fill(Y, Width * Height);
+				Fill(U, ChromaWidth * ChromaHeight);
+				Fill(V, ChromaWidth * ChromaHeight);
+				Fill(UV, ChromaWidth * 2 * ChromaHeight);
+				Fill(Argb, Width * 4 * Height);
+			}
+
+			const int Width;
+			const int Height;
+			const int ChromaWidth;
+			const int ChromaHeight;
+			TArray<uint8> Y;
+			TArray<uint8> U;
+			TArray<uint8> V;
+			TArray<uint8> UV;
+			TArray<uint8> Argb;
+		};
+
+		template <typename TConvert> double MeasureMilliseconds(int Iterations, TConvert&& Convert)
+		{
+			Convert(); // warm up caches
+			const double Start = FPlatformTime::Seconds();
+			for (int i = 0; i < Iterations; ++i)
+			{
+				Convert();
+			}
+			return (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+		}
+
+		int GetMaxDifference(const TArray<uint8>& Lhs, const TArray<uint8>& Rhs)
+		{
+			int Ret = 0;
+			for (int i = 0; i < Lhs.Num(); ++i)
+			{
+				Ret = FMath::Max(Ret, FMath::Abs(Lhs[i] - Rhs[i]));
+			}
+			return Ret;
+		}
+
+		void BenchmarkConverters(const TArray<FString>& Args)
+		{
+			const int Width = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 1920;
+			const int Height = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1080;
+			const int Iterations = Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 100;
+			if (Width <= 0 || Height <= 0 || Iterations <= 0)
+			{
+				DLB_UE_LOG_BASE(Warning, "Usage: DolbyIO.Video.BenchmarkConverters [Width] [Height] [Iterations]");
+				return;
+			}
+
+			const FSyntheticFrame Frame{Width, Height};
+			const int DestStride = Width * 4;
+			TArray<uint8> Reference;
+			TArray<uint8> Dest;
+			Reference.SetNumUninitialized(DestStride * Height);
+			Dest.SetNumUninitialized(DestStride * Height);
+
+			DLB_UE_LOG("Benchmarking video converters on %dx%d frames, %d iterations, using %s as reference", Width,
+			           Height, Iterations, GetReferenceVideoConverter().Name);
+			for (const FVideoConverter* Converter : GetAvailableVideoConverters())
+			{
+				const double I420Ms = MeasureMilliseconds(
+				    Iterations,
+				    [&]
+				    {
+					    Converter->I420ToBgra(Frame.Y.GetData(), Width, Frame.U.GetData(), Frame.ChromaWidth,
+					                          Frame.V.GetData(), Frame.ChromaWidth, Dest.GetData(), DestStride, Width,
+					                          Height);
+				    });
+				GetReferenceVideoConverter().I420ToBgra(Frame.Y.GetData(), Width, Frame.U.GetData(),
+				                                        Frame.ChromaWidth, Frame.V.GetData(), Frame.ChromaWidth,
+				                                        Reference.GetData(), DestStride, Width, Height);
+				const int I420Difference = GetMaxDifference(Reference, Dest);
+
+				const double NV12Ms = MeasureMilliseconds(
+				    Iterations,
+				    [&]
+				    {
+					    Converter->NV12ToBgra(Frame.Y.GetData(), Width, Frame.UV.GetData(), Frame.ChromaWidth * 2,
+					                          Dest.GetData(), DestStride, Width, Height);
+				    });
+				GetReferenceVideoConverter().NV12ToBgra(Frame.Y.GetData(), Width, Frame.UV.GetData(),
+				                                        Frame.ChromaWidth * 2, Reference.GetData(), DestStride,
+				                                        Width, Height);
+				const int NV12Difference = GetMaxDifference(Reference, Dest);
+
+				const double ArgbMs = MeasureMilliseconds(
+				    Iterations,
+				    [&]
+				    {
+					    Converter->CopyArgb(Frame.Argb.GetData(), DestStride, Dest.GetData(), DestStride, Width,
+					                        Height);
+				    });
+
+				DLB_UE_LOG("%-8s I420 %.3f ms (max diff %d) NV12 %.3f ms (max diff %d) ARGB copy %.3f ms",
+				           Converter->Name, I420Ms, I420Difference, NV12Ms, NV12Difference, ArgbMs);
+			}
+		}
+
+		FAutoConsoleCommand BenchmarkConvertersCommand{
+		    TEXT("DolbyIO.Video.BenchmarkConverters"),
+		    TEXT("Measures the time all video converters supported by the CPU take to convert a synthetic frame and "
+		         "how much their output differs from the scalar reference. Arguments: [Width=1920] [Height=1080] "
+		         "[Iterations=100]"),
+		    FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkConverters)};
+	}
+}
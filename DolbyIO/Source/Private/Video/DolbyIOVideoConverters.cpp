@@ -0,0 +1,440 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOVideoConverters.h"
+
+#include "Utils/DolbyIOCppSdk.h"
+
+#include <dolbyio/comms/media_engine/video_utils.h>
+
+#include "HAL/IConsoleManager.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined(__clang__) || defined(__GNUC__)
+#define DLB_TARGET(Features) __attribute__((target(Features)))
+#else
+#define DLB_TARGET(Features)
+#endif
+
+namespace DolbyIO
+{
+	namespace
+	{
+		enum class EConverter : int32
+		{
+			Auto,
+			Sdk,
+			Scalar,
+			Sse41,
+			Avx2,
+			Neon,
+		};
+
+		TAutoConsoleVariable<int32> CVarConverter{
+		    TEXT("DolbyIO.Video.Converter"), static_cast<int32>(EConverter::Auto),
+		    TEXT("Kernels used to convert video frames to BGRA.\n"
+		         "0: fastest one supported by the CPU (default)\n"
+		         "1: SDK\n"
+		         "2: scalar reference\n"
+		         "3: SSE4.1\n"
+		         "4: AVX2\n"
+		         "5: NEON\n"
+		         "Kernels which are not supported by the CPU fall back to the default.")};
+
+		// BT.601 limited range in 6 bit fixed point, small enough for the SIMD kernels to use 16 bit lanes. The luma
+		// scale is 74.5, the half is added with a shift.
+		constexpr int LumaScale = 74;
+		constexpr int VToR = 102;
+		constexpr int UToG = 25;
+		constexpr int VToG = 52;
+		constexpr int UToB = 129;
+		constexpr int Rounding = 32;
+		constexpr int Shift = 6;
+
+		FORCEINLINE uint8 ClampToByte(int Value)
+		{
+			return static_cast<uint8>(FMath::Clamp(Value, 0, 255));
+		}
+
+		FORCEINLINE void YuvToBgra(int Y, int U, int V, uint8* Dest)
+		{
+			const int Luma = (Y - 16) * LumaScale + ((Y - 16) >> 1) + Rounding;
+			U -= 128;
+			V -= 128;
+			Dest[0] = ClampToByte((Luma + UToB * U) >> Shift);
+			Dest[1] = ClampToByte((Luma - UToG * U - VToG * V) >> Shift);
+			Dest[2] = ClampToByte((Luma + VToR * V) >> Shift);
+			Dest[3] = 255;
+		}
+
+		// Converts the row from FirstX on, which the SIMD kernels use for pixels left over at the end of rows
+		void I420RowTail(const uint8* Y, const uint8* U, const uint8* V, uint8* Dest, int FirstX, int Width)
+		{
+			for (int X = FirstX; X < Width; ++X)
+			{
+				YuvToBgra(Y[X], U[X / 2], V[X / 2], Dest + X * 4);
+			}
+		}
+
+		void NV12RowTail(const uint8* Y, const uint8* UV, uint8* Dest, int FirstX, int Width)
+		{
+			for (int X = FirstX; X < Width; ++X)
+			{
+				YuvToBgra(Y[X], UV[X / 2 * 2], UV[X / 2 * 2 + 1], Dest + X * 4);
+			}
+		}
+
+		template <void (*I420Row)(const uint8*, const uint8*, const uint8*, uint8*, int)>
+		void I420ToBgra(const uint8* SrcY, int SrcStrideY, const uint8* SrcU, int SrcStrideU, const uint8* SrcV,
+		                int SrcStrideV, uint8* Dest, int DestStride, int Width, int Height)
+		{
+			for (int Row = 0; Row < Height; ++Row)
+			{
+				I420Row(SrcY + Row * SrcStrideY, SrcU + Row / 2 * SrcStrideU, SrcV + Row / 2 * SrcStrideV,
+				        Dest + Row * DestStride, Width);
+			}
+		}
+
+		template <void (*NV12Row)(const uint8*, const uint8*, uint8*, int)>
+		void NV12ToBgra(const uint8* SrcY, int SrcStrideY, const uint8* SrcUV, int SrcStrideUV, uint8* Dest,
+		                int DestStride, int Width, int Height)
+		{
+			for (int Row = 0; Row < Height; ++Row)
+			{
+				NV12Row(SrcY + Row * SrcStrideY, SrcUV + Row / 2 * SrcStrideUV, Dest + Row * DestStride, Width);
+			}
+		}
+
+		void CopyArgb(const uint8* Src, int SrcStride, uint8* Dest, int DestStride, int Width, int Height)
+		{
+			const int RowBytes = Width * 4;
+			if (SrcStride == RowBytes && DestStride == RowBytes)
+			{
+				FMemory::Memcpy(Dest, Src, RowBytes * Height);
+				return;
+			}
+
+			for (int Row = 0; Row < Height; ++Row)
+			{
+				FMemory::Memcpy(Dest + Row * DestStride, Src + Row * SrcStride, RowBytes);
+			}
+		}
+
+		void I420RowScalar(const uint8* Y, const uint8* U, const uint8* V, uint8* Dest, int Width)
+		{
+			I420RowTail(Y, U, V, Dest, 0, Width);
+		}
+
+		void NV12RowScalar(const uint8* Y, const uint8* UV, uint8* Dest, int Width)
+		{
+			NV12RowTail(Y, UV, Dest, 0, Width);
+		}
+
+#if PLATFORM_CPU_X86_FAMILY
+		// Converts 8 pixels given as 16 bit lanes
+		DLB_TARGET("sse4.1") void StoreBgraSse41(__m128i Y, __m128i U, __m128i V, uint8* Dest)
+		{
+			Y = _mm_sub_epi16(Y, _mm_set1_epi16(16));
+			const __m128i Luma = _mm_adds_epi16(
+			    _mm_add_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(LumaScale)), _mm_srai_epi16(Y, 1)),
+			    _mm_set1_epi16(Rounding));
+			U = _mm_sub_epi16(U, _mm_set1_epi16(128));
+			V = _mm_sub_epi16(V, _mm_set1_epi16(128));
+
+			const __m128i B = _mm_srai_epi16(_mm_adds_epi16(Luma, _mm_mullo_epi16(U, _mm_set1_epi16(UToB))), Shift);
+			const __m128i G =
+			    _mm_srai_epi16(_mm_subs_epi16(_mm_subs_epi16(Luma, _mm_mullo_epi16(U, _mm_set1_epi16(UToG))),
+			                                  _mm_mullo_epi16(V, _mm_set1_epi16(VToG))),
+			                   Shift);
+			const __m128i R = _mm_srai_epi16(_mm_adds_epi16(Luma, _mm_mullo_epi16(V, _mm_set1_epi16(VToR))), Shift);
+
+			const __m128i BG = _mm_unpacklo_epi8(_mm_packus_epi16(B, B), _mm_packus_epi16(G, G));
+			const __m128i RA = _mm_unpacklo_epi8(_mm_packus_epi16(R, R), _mm_set1_epi8(-1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest), _mm_unpacklo_epi16(BG, RA));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dest + 16), _mm_unpackhi_epi16(BG, RA));
+		}
+
+		DLB_TARGET("sse4.1") void I420RowSse41(const uint8* Y, const uint8* U, const uint8* V, uint8* Dest, int Width)
+		{
+			// Widens 4 chroma bytes to 8 lanes, each sample repeated for two pixels
+			const __m128i DuplicateChroma = _mm_setr_epi8(0, -1, 0, -1, 1, -1, 1, -1, 2, -1, 2, -1, 3, -1, 3, -1);
+			int X = 0;
+			for (; X + 8 <= Width; X += 8)
+			{
+				int32 Us, Vs;
+				FMemory::Memcpy(&Us, U + X / 2, sizeof(Us));
+				FMemory::Memcpy(&Vs, V + X / 2, sizeof(Vs));
+				StoreBgraSse41(_mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Y + X))),
+				               _mm_shuffle_epi8(_mm_cvtsi32_si128(Us), DuplicateChroma),
+				               _mm_shuffle_epi8(_mm_cvtsi32_si128(Vs), DuplicateChroma), Dest + X * 4);
+			}
+			I420RowTail(Y, U, V, Dest, X, Width);
+		}
+
+		DLB_TARGET("sse4.1") void NV12RowSse41(const uint8* Y, const uint8* UV, uint8* Dest, int Width)
+		{
+			const __m128i DuplicateU = _mm_setr_epi8(0, -1, 0, -1, 2, -1, 2, -1, 4, -1, 4, -1, 6, -1, 6, -1);
+			const __m128i DuplicateV = _mm_setr_epi8(1, -1, 1, -1, 3, -1, 3, -1, 5, -1, 5, -1, 7, -1, 7, -1);
+			int X = 0;
+			for (; X + 8 <= Width; X += 8)
+			{
+				const __m128i Chroma = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(UV + X));
+				StoreBgraSse41(_mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Y + X))),
+				               _mm_shuffle_epi8(Chroma, DuplicateU), _mm_shuffle_epi8(Chroma, DuplicateV),
+				               Dest + X * 4);
+			}
+			NV12RowTail(Y, UV, Dest, X, Width);
+		}
+
+		// Converts 16 pixels given as 16 bit lanes
+		DLB_TARGET("avx2") void StoreBgraAvx2(__m256i Y, __m256i U, __m256i V, uint8* Dest)
+		{
+			Y = _mm256_sub_epi16(Y, _mm256_set1_epi16(16));
+			const __m256i Luma = _mm256_adds_epi16(
+			    _mm256_add_epi16(_mm256_mullo_epi16(Y, _mm256_set1_epi16(LumaScale)), _mm256_srai_epi16(Y, 1)),
+			    _mm256_set1_epi16(Rounding));
+			U = _mm256_sub_epi16(U, _mm256_set1_epi16(128));
+			V = _mm256_sub_epi16(V, _mm256_set1_epi16(128));
+
+			const __m256i B =
+			    _mm256_srai_epi16(_mm256_adds_epi16(Luma, _mm256_mullo_epi16(U, _mm256_set1_epi16(UToB))), Shift);
+			const __m256i G = _mm256_srai_epi16(
+			    _mm256_subs_epi16(_mm256_subs_epi16(Luma, _mm256_mullo_epi16(U, _mm256_set1_epi16(UToG))),
+			                      _mm256_mullo_epi16(V, _mm256_set1_epi16(VToG))),
+			    Shift);
+			const __m256i R =
+			    _mm256_srai_epi16(_mm256_adds_epi16(Luma, _mm256_mullo_epi16(V, _mm256_set1_epi16(VToR))), Shift);
+
+			// Packing and unpacking work within 128 bit lanes, which hold pixels 0-7 and 8-15 respectively
+			const __m256i BG = _mm256_unpacklo_epi8(_mm256_packus_epi16(B, B), _mm256_packus_epi16(G, G));
+			const __m256i RA = _mm256_unpacklo_epi8(_mm256_packus_epi16(R, R), _mm256_set1_epi8(-1));
+			const __m256i Low = _mm256_unpacklo_epi16(BG, RA);  // pixels 0-3 and 8-11
+			const __m256i High = _mm256_unpackhi_epi16(BG, RA); // pixels 4-7 and 12-15
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dest), _mm256_permute2x128_si256(Low, High, 0x20));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(Dest + 32), _mm256_permute2x128_si256(Low, High, 0x31));
+		}
+
+		DLB_TARGET("avx2") void I420RowAvx2(const uint8* Y, const uint8* U, const uint8* V, uint8* Dest, int Width)
+		{
+			int X = 0;
+			for (; X + 16 <= Width; X += 16)
+			{
+				const __m128i Us = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(U + X / 2));
+				const __m128i Vs = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(V + X / 2));
+				StoreBgraAvx2(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Y + X))),
+				              _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(Us, Us)),
+				              _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(Vs, Vs)), Dest + X * 4);
+			}
+			I420RowTail(Y, U, V, Dest, X, Width);
+		}
+
+		DLB_TARGET("avx2") void NV12RowAvx2(const uint8* Y, const uint8* UV, uint8* Dest, int Width)
+		{
+			const __m128i DuplicateU = _mm_setr_epi8(0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14);
+			const __m128i DuplicateV = _mm_setr_epi8(1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15);
+			int X = 0;
+			for (; X + 16 <= Width; X += 16)
+			{
+				const __m128i Chroma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(UV + X));
+				StoreBgraAvx2(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Y + X))),
+				              _mm256_cvtepu8_epi16(_mm_shuffle_epi8(Chroma, DuplicateU)),
+				              _mm256_cvtepu8_epi16(_mm_shuffle_epi8(Chroma, DuplicateV)), Dest + X * 4);
+			}
+			NV12RowTail(Y, UV, Dest, X, Width);
+		}
+
+#if defined(_MSC_VER)
+		DLB_TARGET("xsave") uint64 GetEnabledXStateFeatures()
+		{
+			return _xgetbv(0);
+		}
+#endif
+
+		struct FCpuFeatures
+		{
+			bool bHasSse41 = false;
+			bool bHasAvx2 = false;
+
+			FCpuFeatures()
+			{
+#if defined(_MSC_VER)
+				int Info[4];
+				__cpuid(Info, 0);
+				const int MaxLeaf = Info[0];
+				__cpuid(Info, 1);
+				bHasSse41 = Info[2] & (1 << 19);
+				// AVX2 also needs the OS to save the upper halves of the YMM registers
+				const bool bHasOsYmmSupport = (Info[2] & (1 << 27)) && (GetEnabledXStateFeatures() & 0b110) == 0b110;
+				if (MaxLeaf >= 7)
+				{
+					__cpuidex(Info, 7, 0);
+					bHasAvx2 = bHasOsYmmSupport && (Info[1] & (1 << 5));
+				}
+#else
+				__builtin_cpu_init();
+				bHasSse41 = __builtin_cpu_supports("sse4.1");
+				bHasAvx2 = __builtin_cpu_supports("avx2");
+#endif
+			}
+		};
+
+		const FCpuFeatures& GetCpuFeatures()
+		{
+			static const FCpuFeatures CpuFeatures;
+			return CpuFeatures;
+		}
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+		// Converts 8 pixels
+		void StoreBgraNeon(uint8x8_t Y, uint8x8_t U, uint8x8_t V, uint8* Dest)
+		{
+			const int16x8_t Y16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(Y)), vdupq_n_s16(16));
+			const int16x8_t Luma =
+			    vqaddq_s16(vaddq_s16(vmulq_n_s16(Y16, LumaScale), vshrq_n_s16(Y16, 1)), vdupq_n_s16(Rounding));
+			const int16x8_t Cb = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(U)), vdupq_n_s16(128));
+			const int16x8_t Cr = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(V)), vdupq_n_s16(128));
+
+			uint8x8x4_t Bgra;
+			Bgra.val[0] = vqmovun_s16(vshrq_n_s16(vqaddq_s16(Luma, vmulq_n_s16(Cb, UToB)), Shift));
+			Bgra.val[1] = vqmovun_s16(
+			    vshrq_n_s16(vqsubq_s16(vqsubq_s16(Luma, vmulq_n_s16(Cb, UToG)), vmulq_n_s16(Cr, VToG)), Shift));
+			Bgra.val[2] = vqmovun_s16(vshrq_n_s16(vqaddq_s16(Luma, vmulq_n_s16(Cr, VToR)), Shift));
+			Bgra.val[3] = vdup_n_u8(255);
+			vst4_u8(Dest, Bgra);
+		}
+
+		// Converts 16 pixels, given 8 samples of each chroma plane
+		void StoreBgraNeon(uint8x16_t Y, uint8x8_t U, uint8x8_t V, uint8* Dest)
+		{
+			const uint8x8x2_t Us = vzip_u8(U, U);
+			const uint8x8x2_t Vs = vzip_u8(V, V);
+			StoreBgraNeon(vget_low_u8(Y), Us.val[0], Vs.val[0], Dest);
+			StoreBgraNeon(vget_high_u8(Y), Us.val[1], Vs.val[1], Dest + 32);
+		}
+
+		void I420RowNeon(const uint8* Y, const uint8* U, const uint8* V, uint8* Dest, int Width)
+		{
+			int X = 0;
+			for (; X + 16 <= Width; X += 16)
+			{
+				StoreBgraNeon(vld1q_u8(Y + X), vld1_u8(U + X / 2), vld1_u8(V + X / 2), Dest + X * 4);
+			}
+			I420RowTail(Y, U, V, Dest, X, Width);
+		}
+
+		void NV12RowNeon(const uint8* Y, const uint8* UV, uint8* Dest, int Width)
+		{
+			int X = 0;
+			for (; X + 16 <= Width; X += 16)
+			{
+				const uint8x8x2_t Chroma = vld2_u8(UV + X);
+				StoreBgraNeon(vld1q_u8(Y + X), Chroma.val[0], Chroma.val[1], Dest + X * 4);
+			}
+			NV12RowTail(Y, UV, Dest, X, Width);
+		}
+#endif
+
+		void I420ToBgraSdk(const uint8* SrcY, int SrcStrideY, const uint8* SrcU, int SrcStrideU, const uint8* SrcV,
+		                   int SrcStrideV, uint8* Dest, int DestStride, int Width, int Height)
+		{
+			dolbyio::comms::video_utils::format_converter::i420_to_argb(SrcY, SrcStrideY, SrcU, SrcStrideU, SrcV,
+			                                                            SrcStrideV, Dest, DestStride, Width, Height);
+		}
+
+		void NV12ToBgraSdk(const uint8* SrcY, int SrcStrideY, const uint8* SrcUV, int SrcStrideUV, uint8* Dest,
+		                   int DestStride, int Width, int Height)
+		{
+			dolbyio::comms::video_utils::format_converter::nv12_to_argb(SrcY, SrcStrideY, SrcUV, SrcStrideUV, Dest,
+			                                                            DestStride, Width, Height);
+		}
+
+		void CopyArgbSdk(const uint8* Src, int SrcStride, uint8* Dest, int DestStride, int Width, int Height)
+		{
+			dolbyio::comms::video_utils::format_converter::argb_copy(Src, SrcStride, Dest, DestStride, Width, Height);
+		}
+
+		const FVideoConverter SdkConverter{TEXT("SDK"), &I420ToBgraSdk, &NV12ToBgraSdk, &CopyArgbSdk};
+		const FVideoConverter ScalarConverter{TEXT("Scalar"), &I420ToBgra<&I420RowScalar>,
+		                                      &NV12ToBgra<&NV12RowScalar>, &CopyArgb};
+#if PLATFORM_CPU_X86_FAMILY
+		const FVideoConverter Sse41Converter{TEXT("SSE4.1"), &I420ToBgra<&I420RowSse41>, &NV12ToBgra<&NV12RowSse41>,
+		                                     &CopyArgb};
+		const FVideoConverter Avx2Converter{TEXT("AVX2"), &I420ToBgra<&I420RowAvx2>, &NV12ToBgra<&NV12RowAvx2>,
+		                                    &CopyArgb};
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+		const FVideoConverter NeonConverter{TEXT("NEON"), &I420ToBgra<&I420RowNeon>, &NV12ToBgra<&NV12RowNeon>,
+		                                    &CopyArgb};
+#endif
+
+		const FVideoConverter* GetConverter(EConverter Converter)
+		{
+			switch (Converter)
+			{
+				case EConverter::Sdk:
+					return &SdkConverter;
+				case EConverter::Scalar:
+					return &ScalarConverter;
+#if PLATFORM_CPU_X86_FAMILY
+				case EConverter::Sse41:
+					return GetCpuFeatures().bHasSse41 ? &Sse41Converter : nullptr;
+				case EConverter::Avx2:
+					return GetCpuFeatures().bHasAvx2 ? &Avx2Converter : nullptr;
+#elif PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+				case EConverter::Neon:
+					return &NeonConverter;
+#endif
+				default:
+					return nullptr;
+			}
+		}
+
+		const FVideoConverter& GetFastestConverter()
+		{
+			for (EConverter Converter : {EConverter::Avx2, EConverter::Sse41, EConverter::Neon})
+			{
+				if (const FVideoConverter* Ret = GetConverter(Converter))
+				{
+					return *Ret;
+				}
+			}
+			return SdkConverter;
+		}
+	}
+
+	const FVideoConverter& GetVideoConverter()
+	{
+		if (const FVideoConverter* Converter =
+		        GetConverter(static_cast<EConverter>(CVarConverter.GetValueOnAnyThread())))
+		{
+			return *Converter;
+		}
+
+		static const FVideoConverter& FastestConverter = GetFastestConverter();
+		return FastestConverter;
+	}
+
+	TArray<const FVideoConverter*> GetAvailableVideoConverters()
+	{
+		TArray<const FVideoConverter*> Ret;
+		for (EConverter Converter :
+		     {EConverter::Sdk, EConverter::Scalar, EConverter::Sse41, EConverter::Avx2, EConverter::Neon})
+		{
+			if (const FVideoConverter* Available = GetConverter(Converter))
+			{
+				Ret.Add(Available);
+			}
+		}
+		return Ret;
+	}
+
+	const FVideoConverter& GetReferenceVideoConverter()
+	{
+		return ScalarConverter;
+	}
+}
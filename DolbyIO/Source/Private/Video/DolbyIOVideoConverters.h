@@ -0,0 +1,27 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "Containers/Array.h"
+
+namespace DolbyIO
+{
+	// A set of kernels converting decoded frames to the BGRA layout of video textures. YUV input is treated as BT.601
+	// limited range, like the SDK does.
+	struct FVideoConverter
+	{
+		const TCHAR* Name;
+		void (*I420ToBgra)(const uint8* SrcY, int SrcStrideY, const uint8* SrcU, int SrcStrideU, const uint8* SrcV,
+		                   int SrcStrideV, uint8* Dest, int DestStride, int Width, int Height);
+		void (*NV12ToBgra)(const uint8* SrcY, int SrcStrideY, const uint8* SrcUV, int SrcStrideUV, uint8* Dest,
+		                   int DestStride, int Width, int Height);
+		void (*CopyArgb)(const uint8* Src, int SrcStride, uint8* Dest, int DestStride, int Width, int Height);
+	};
+
+	// The converter selected with DolbyIO.Video.Converter, or the fastest one supported by the CPU.
+	const FVideoConverter& GetVideoConverter();
+
+	// All converters supported by the CPU, starting with the SDK's and the scalar reference implementation.
+	TArray<const FVideoConverter*> GetAvailableVideoConverters();
+	const FVideoConverter& GetReferenceVideoConverter();
+}
@@ -0,0 +1,70 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOVideoPlanes.h"
+
+#include "HAL/UnrealMemory.h"
+
+namespace DolbyIO
+{
+	void CopyPlane(const uint8* Src, int SrcStride, uint8* Dest, int DestStride, int RowBytes, int Rows)
+	{
+		if (SrcStride == RowBytes && DestStride == RowBytes)
+		{
+			FMemory::Memcpy(Dest, Src, RowBytes * Rows);
+			return;
+		}
+
+		for (int Row = 0; Row < Rows; ++Row)
+		{
+			FMemory::Memcpy(Dest + Row * DestStride, Src + Row * SrcStride, RowBytes);
+		}
+	}
+
+	void DecimatePlane(const uint8* Src, int SrcStride, uint8* Dest, int DestStride, int BytesPerPixel, int Width,
+	                   int Rows, int Factor)
+	{
+		const int SrcPixelStep = BytesPerPixel * Factor;
+		for (int Row = 0; Row < Rows; ++Row)
+		{
+			const uint8* SrcRow = Src + Row * Factor * SrcStride;
+			uint8* DestRow = Dest + Row * DestStride;
+			for (int X = 0; X < Width; ++X)
+			{
+				FMemory::Memcpy(DestRow + X * BytesPerPixel, SrcRow + X * SrcPixelStep, BytesPerPixel);
+			}
+		}
+	}
+
+	void InterleavePlanes(const uint8* SrcU, int SrcStrideU, const uint8* SrcV, int SrcStrideV, uint8* DestUV,
+	                      int DestStride, int Width, int Rows)
+	{
+		for (int Row = 0; Row < Rows; ++Row)
+		{
+			const uint8* U = SrcU + Row * SrcStrideU;
+			const uint8* V = SrcV + Row * SrcStrideV;
+			uint8* UV = DestUV + Row * DestStride;
+			for (int X = 0; X < Width; ++X)
+			{
+				UV[2 * X] = U[X];
+				UV[2 * X + 1] = V[X];
+			}
+		}
+	}
+
+	void PackI420(const uint8* SrcY, int SrcStrideY, const uint8* SrcU, int SrcStrideU, const uint8* SrcV,
+	              int SrcStrideV, uint8* Dest, int Width, int Height)
+	{
+		const int ChromaWidth = GetChromaSize(Width);
+		CopyPlane(SrcY, SrcStrideY, Dest, Width, Width, Height);
+		InterleavePlanes(SrcU, SrcStrideU, SrcV, SrcStrideV, Dest + Width * Height, ChromaWidth * 2, ChromaWidth,
+		                 GetChromaSize(Height));
+	}
+
+	void PackNV12(const uint8* SrcY, int SrcStrideY, const uint8* SrcUV, int SrcStrideUV, uint8* Dest, int Width,
+	              int Height)
+	{
+		const int ChromaWidth = GetChromaSize(Width);
+		CopyPlane(SrcY, SrcStrideY, Dest, Width, Width, Height);
+		CopyPlane(SrcUV, SrcStrideUV, Dest + Width * Height, ChromaWidth * 2, ChromaWidth * 2, GetChromaSize(Height));
+	}
+}
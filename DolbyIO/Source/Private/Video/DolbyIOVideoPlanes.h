@@ -0,0 +1,33 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "CoreTypes.h"
+
+namespace DolbyIO
+{
+	// Layout of frames uploaded in planar YUV format: a full resolution luma plane of one byte per pixel, directly
+	// followed by a half resolution plane of interleaved U and V bytes. These functions only shuffle memory and do not
+	// depend on any rendering resources.
+	inline int GetChromaSize(int LumaSize)
+	{
+		return (LumaSize + 1) / 2;
+	}
+
+	inline int GetPlanarFrameSize(int Width, int Height)
+	{
+		return Width * Height + GetChromaSize(Width) * GetChromaSize(Height) * 2;
+	}
+
+	void CopyPlane(const uint8* Src, int SrcStride, uint8* Dest, int DestStride, int RowBytes, int Rows);
+	// Copies every Factor-th pixel of every Factor-th row, for converting frames at a reduced resolution
+	void DecimatePlane(const uint8* Src, int SrcStride, uint8* Dest, int DestStride, int BytesPerPixel, int Width,
+	                   int Rows, int Factor);
+	void InterleavePlanes(const uint8* SrcU, int SrcStrideU, const uint8* SrcV, int SrcStrideV, uint8* DestUV,
+	                      int DestStride, int Width, int Rows);
+
+	void PackI420(const uint8* SrcY, int SrcStrideY, const uint8* SrcU, int SrcStrideU, const uint8* SrcV,
+	              int SrcStrideV, uint8* Dest, int Width, int Height);
+	void PackNV12(const uint8* SrcY, int SrcStrideY, const uint8* SrcUV, int SrcStrideUV, uint8* Dest, int Width,
+	              int Height);
+}
@@ -2,14 +2,24 @@
 
 #include "DolbyIOVideoSink.h"
 
+#include "DolbyIOVideoConverters.h"
+#include "DolbyIOVideoPlanes.h"
 #include "DolbyIOVideoTexture.h"
+#include "DolbyIOTypes.h"
+#include "Subsystem/DolbyIOEventTrace.h"
 #include "Utils/DolbyIOLogging.h"
-
-#include <dolbyio/comms/media_engine/video_utils.h>
+#include "Utils/DolbyIOMemory.h"
+#include "Utils/DolbyIOTrace.h"
 
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
 #include "Engine/Texture2D.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Hash/CityHash.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "RenderingThread.h"
 
 namespace DolbyIO
 {
@@ -18,27 +28,157 @@ namespace DolbyIO
 	namespace
 	{
 		constexpr auto TexParamName = "DolbyIO Frame";
+		constexpr auto LumaTexParamName = "DolbyIO Frame Y";
+		constexpr auto ChromaTexParamName = "DolbyIO Frame UV";
+
+		TAutoConsoleVariable<bool> CVarDirectUpload{
+		    TEXT("DolbyIO.Video.DirectUpload"), true,
+		    TEXT("If true, texture uploads are enqueued for the render thread directly from the thread delivering "
+		         "video frames. The game thread is only involved when a texture needs to be resized, or when rendering "
+		         "does not run on a thread of its own.")};
+
+		TAutoConsoleVariable<bool> CVarDirtyRegionUploads{
+		    TEXT("DolbyIO.Video.DirtyRegionUploads"), true,
+		    TEXT("If true, only the regions which changed since the previous frame are uploaded for screenshare "
+		         "tracks.")};
+
+		enum class EFrameHashMode : int32
+		{
+			Disabled,
+			SampledRows,
+			FullPlanes,
+		};
+
+		TAutoConsoleVariable<int32> CVarFrameHashMode{
+		    TEXT("DolbyIO.Video.SkipIdenticalFrames"), static_cast<int32>(EFrameHashMode::Disabled),
+		    TEXT("Whether frames identical to the previous one are detected by hashing and neither converted nor "
+		         "uploaded.\n"
+		         "0: disabled (default)\n"
+		         "1: hash a few rows of each plane - cheapest, but changes in other rows go unnoticed until a sampled "
+		         "row changes too\n"
+		         "2: hash the whole planes")};
+
+		constexpr int NumSampledRows = 16;
+
+		TAutoConsoleVariable<int32> CVarOutputFormat{
+		    TEXT("DolbyIO.Video.OutputFormat"), static_cast<int32>(EVideoTextureFormat::Bgra),
+		    TEXT("Format of textures created for new video tracks.\n"
+		         "0: BGRA converted on the CPU, bound to the \"DolbyIO Frame\" material parameter (default)\n"
+		         "1: planar YUV converted by the material, bound to the \"DolbyIO Frame Y\" and \"DolbyIO Frame UV\" "
+		         "material parameters. Only used for tracks delivering YUV frames.")};
+
+		TAutoConsoleVariable<int32> CVarParallelConversionMinPixels{
+		    TEXT("DolbyIO.Video.ParallelConversionMinPixels"), 1920 * 1080,
+		    TEXT("Frames with at least this many pixels are converted in horizontal stripes on the task graph "
+		         "instead of only on the thread delivering them. 0 disables parallel conversion.")};
+
+		constexpr int MaxConversionStripes = 8;
+
+		// Calls ConvertStripe(FirstRow, NumRows) for horizontal stripes covering the whole frame. Stripes start at even
+		// rows so that they never split a row pair sharing chroma samples.
+		template <typename TConvertStripe> void ConvertInStripes(int Width, int Height, TConvertStripe&& ConvertStripe)
+		{
+			const int32 MinPixels = CVarParallelConversionMinPixels.GetValueOnAnyThread();
+			const int NumStripes =
+			    MinPixels > 0 && Width * Height >= MinPixels
+			        ? FMath::Min(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, MaxConversionStripes)
+			        : 1;
+			if (NumStripes <= 1)
+			{
+				ConvertStripe(0, Height);
+				return;
+			}
+
+			const int RowsPerStripe = Align(FMath::DivideAndRoundUp(Height, NumStripes), 2);
+			ParallelFor(NumStripes,
+			            [&](int32 Stripe)
+			            {
+				            const int FirstRow = Stripe * RowsPerStripe;
+				            const int NumRows = FMath::Min(RowsPerStripe, Height - FirstRow);
+				            if (NumRows > 0)
+				            {
+					            ConvertStripe(FirstRow, NumRows);
+				            }
+			            });
+		}
+
+		void BindMaterialImpl(UMaterialInstanceDynamic& Material, FVideoTexture& Texture)
+		{
+			if (Texture.GetFormat() == EVideoTextureFormat::PlanarYuv)
+			{
+				Material.SetTextureParameterValue(LumaTexParamName, Texture.GetTexture());
+				Material.SetTextureParameterValue(ChromaTexParamName, Texture.GetChromaTexture());
+			}
+			else
+			{
+				Material.SetTextureParameterValue(TexParamName, Texture.GetTexture());
+			}
+		}
+
+		// Lowers the shift until the downscaled size is at least 2x2
+		int ClampDownscaleShift(int Width, int Height, int Shift)
+		{
+			while (Shift > 0 && ((Width >> Shift) < 2 || (Height >> Shift) < 2))
+			{
+				--Shift;
+			}
+			return Shift;
+		}
+
+		// Keeps downscaled sizes even so that they never split the pixels sharing chroma samples
+		FIntPoint GetDownscaledSize(int Width, int Height, int Shift)
+		{
+			return Shift ? FIntPoint{(Width >> Shift) & ~1, (Height >> Shift) & ~1} : FIntPoint{Width, Height};
+		}
 
 		void UnbindMaterialImpl(UMaterialInstanceDynamic& Material)
 		{
-			Material.SetTextureParameterValue(TexParamName, FVideoTexture::GetEmptyTexture());
+			UTexture2D* EmptyTexture = FVideoTexture::GetEmptyTexture();
+			Material.SetTextureParameterValue(TexParamName, EmptyTexture);
+			Material.SetTextureParameterValue(LumaTexParamName, EmptyTexture);
+			Material.SetTextureParameterValue(ChromaTexParamName, EmptyTexture);
 		}
 	}
 
-	FVideoSink::FVideoSink(const FString& VideoTrackID) : VideoTrackID(VideoTrackID) {}
+	FVideoSink::FVideoSink(const FString& VideoTrackID, const FString& ParticipantID)
+	    : VideoTrackID(VideoTrackID), ParticipantID(ParticipantID),
+	      StatsName(ParticipantID.IsEmpty() ? VideoTrackID : ParticipantID + TEXT("/") + VideoTrackID)
+	{
+#if DLB_VIDEO_STATS && CSV_PROFILER
+		const TCHAR* StatSuffixes[] = {TEXT("InputFps"), TEXT("RenderedFps"), TEXT("DroppedFps"), TEXT("CoalescedFps"),
+		                               TEXT("ConversionUsPerFrame"), TEXT("ConversionUsPerSecond"),
+		                               TEXT("LockWaitUsPerSecond"), TEXT("UploadedKBps"), TEXT("QueueAgeMs")};
+		static_assert(UE_ARRAY_COUNT(StatSuffixes) == UE_ARRAY_COUNT(StatNames), "One suffix per stat");
+		for (int i = 0; i < UE_ARRAY_COUNT(StatNames); ++i)
+		{
+			StatNames[i] = FName{StatsName + TEXT("/") + StatSuffixes[i]};
+		}
+#endif
+	}
+
+	FVideoSink::~FVideoSink()
+	{
+		DLB_UE_LOG_BASE(Verbose, "Video track ID %s frames: received %llu coalesced %llu dropped %llu skipped %llu",
+		                *VideoTrackID, Counters.ReceivedFrames.load(), Counters.CoalescedFrames.load(),
+		                Counters.DroppedFrames.load(), Counters.SkippedFrames.load());
+	}
 
 	void FVideoSink::OnTextureCreated(FOnTextureCreated OnTextureCreated)
 	{
-		if (Texture)
 		{
-			return OnTextureCreated();
+			FScopeLock Lock{&OnTexCreatedLock};
+			if (!bIsTextureReady)
+			{
+				OnTexCreated = MoveTemp(OnTextureCreated);
+				return;
+			}
 		}
-		OnTexCreated = MoveTemp(OnTextureCreated);
+		OnTextureCreated();
 	}
 
 	UTexture2D* FVideoSink::GetTexture()
 	{
-		return Texture ? Texture->GetTexture() : nullptr;
+		return bIsTextureReady ? Texture->GetTexture() : nullptr;
 	}
 
 	void FVideoSink::BindMaterial(UMaterialInstanceDynamic* Material)
@@ -47,9 +187,9 @@ namespace DolbyIO
 		{
 			DLB_UE_LOG("Binding material %u to video track ID %s", Material->GetUniqueID(), *VideoTrackID);
 			Materials.Add(Material);
-			if (Texture)
+			if (bIsTextureReady)
 			{
-				Material->SetTextureParameterValue(TexParamName, GetTexture());
+				BindMaterialImpl(*Material, *Texture);
 			}
 		}
 	}
@@ -83,6 +223,159 @@ namespace DolbyIO
 		bIsEnabled = false;
 	}
 
+	void FVideoSink::EnableDirtyRegionUploads()
+	{
+		bIsDirtyRegionUploadEnabled = true;
+	}
+
+	void FVideoSink::SetTraceRecorder(std::shared_ptr<FEventTraceRecorder> Recorder)
+	{
+		std::atomic_store(&TraceRecorder, MoveTemp(Recorder));
+	}
+
+	const FVideoSink::FCounters& FVideoSink::GetCounters() const
+	{
+		return Counters;
+	}
+
+	void FVideoSink::SetDownscale(int Shift)
+	{
+		DownscaleShift = FMath::Clamp(Shift, 0, MaxDownscaleShift);
+	}
+
+	int FVideoSink::GetDownscaleShift() const
+	{
+		return DownscaleShift;
+	}
+
+	bool FVideoSink::HasMaterials() const
+	{
+		return Materials.Num() > 0;
+	}
+
+	const FString& FVideoSink::GetParticipantID() const
+	{
+		return ParticipantID;
+	}
+
+	SIZE_T FVideoSink::GetMemorySize() const
+	{
+		return bIsTextureReady ? Texture->GetMemorySize() : 0;
+	}
+
+	SIZE_T FVideoSink::EstimateMemorySize(int Shift) const
+	{
+		if (!bIsTextureReady)
+		{
+			return 0;
+		}
+		const int Width = SourceWidth;
+		const int Height = SourceHeight;
+		const FIntPoint Size = GetDownscaledSize(Width, Height, ClampDownscaleShift(Width, Height, Shift));
+		return FVideoTexture::EstimateMemorySize(Size.X, Size.Y, Texture->GetFormat());
+	}
+
+	void FVideoSink::GetPerformance(double Now, FDolbyIOVideoTrackPerformance& Performance)
+	{
+		if (Performance.TrackID != VideoTrackID)
+		{
+			Performance.TrackID = VideoTrackID;
+		}
+		if (Performance.ParticipantID != ParticipantID)
+		{
+			Performance.ParticipantID = ParticipantID;
+		}
+		Performance.ReceivedFrames = Counters.ReceivedFrames;
+		Performance.DroppedFrames = Counters.DroppedFrames;
+		Performance.CoalescedFrames = Counters.CoalescedFrames;
+		Performance.DownscaleFactor = 1 << DownscaleShift;
+		if (!bIsTextureReady)
+		{
+			Performance.Width = 0;
+			Performance.Height = 0;
+			Performance.TextureMemoryBytes = 0;
+			Performance.InputFps = 0.f;
+			Performance.RenderedFps = 0.f;
+			Performance.ConversionMs = 0.f;
+			return;
+		}
+
+		Performance.Width = Texture->GetWidth();
+		Performance.Height = Texture->GetHeight();
+		Performance.TextureMemoryBytes = Texture->GetMemorySize();
+		Performance.InputFps = InputRate.Update(Counters.ReceivedFrames, Now);
+		Performance.RenderedFps = RenderRate.Update(Texture->GetUploadCounters().Frames, Now);
+		const double ConversionsPerSecond = ConversionRate.Update(Counters.ConvertedFrames, Now);
+		const double ConversionCyclesPerSecond = ConversionCycleRate.Update(Counters.ConversionCycles, Now);
+		Performance.ConversionMs =
+		    ConversionsPerSecond > 0.0 ? ConversionCyclesPerSecond * FPlatformTime::GetSecondsPerCycle64() * 1000.0 /
+		                                     ConversionsPerSecond
+		                               : 0.f;
+	}
+
+#if DLB_VIDEO_STATS
+	void FVideoSink::UpdateStats(double Seconds)
+	{
+		if (!bIsTextureReady || Seconds <= 0)
+		{
+			return;
+		}
+
+		const FVideoTexture::FUploadCounters& UploadCounters = Texture->GetUploadCounters();
+		FStatsSnapshot Stats;
+		Stats.ReceivedFrames = Counters.ReceivedFrames;
+		Stats.DroppedFrames = Counters.DroppedFrames;
+		Stats.CoalescedFrames = Counters.CoalescedFrames;
+		Stats.ConvertedFrames = Counters.ConvertedFrames;
+		Stats.ConversionCycles = Counters.ConversionCycles;
+		Stats.UploadedFrames = UploadCounters.Frames;
+		Stats.UploadedBytes = UploadCounters.Bytes;
+		Stats.QueueAgeCycles = UploadCounters.QueueAgeCycles;
+		Stats.LockWaitCycles = UploadCounters.LockWaitCycles;
+
+		const uint64 UploadedFrames = Stats.UploadedFrames - PreviousStats.UploadedFrames;
+		const double InputFps = (Stats.ReceivedFrames - PreviousStats.ReceivedFrames) / Seconds;
+		const double RenderedFps = UploadedFrames / Seconds;
+		const double DroppedFps = (Stats.DroppedFrames - PreviousStats.DroppedFrames) / Seconds;
+		const double CoalescedFps = (Stats.CoalescedFrames - PreviousStats.CoalescedFrames) / Seconds;
+		const uint64 ConvertedFrames = Stats.ConvertedFrames - PreviousStats.ConvertedFrames;
+		const double ConversionUs =
+		    FPlatformTime::ToMilliseconds64(Stats.ConversionCycles - PreviousStats.ConversionCycles) * 1000.0;
+		const double ConversionUsPerFrame = ConvertedFrames ? ConversionUs / ConvertedFrames : 0.0;
+		const double ConversionUsPerSecond = ConversionUs / Seconds;
+		const double LockWaitUs =
+		    FPlatformTime::ToMilliseconds64(Stats.LockWaitCycles - PreviousStats.LockWaitCycles) * 1000.0 / Seconds;
+		const double UploadedKBps = (Stats.UploadedBytes - PreviousStats.UploadedBytes) / 1024.0 / Seconds;
+		const double QueueAgeMs =
+		    UploadedFrames
+		        ? FPlatformTime::ToMilliseconds64(Stats.QueueAgeCycles - PreviousStats.QueueAgeCycles) / UploadedFrames
+		        : 0.0;
+		PreviousStats = Stats;
+
+#if CSV_PROFILER
+		auto RecordStat = [this](EStat Stat, double Value)
+		{
+			FCsvProfiler::RecordCustomStat(StatNames[static_cast<int>(Stat)], CSV_CATEGORY_INDEX(DolbyIO),
+			                               static_cast<float>(Value), ECsvCustomStatOp::Set);
+		};
+		RecordStat(EStat::InputFps, InputFps);
+		RecordStat(EStat::RenderedFps, RenderedFps);
+		RecordStat(EStat::DroppedFps, DroppedFps);
+		RecordStat(EStat::CoalescedFps, CoalescedFps);
+		RecordStat(EStat::ConversionUsPerFrame, ConversionUsPerFrame);
+		RecordStat(EStat::ConversionUsPerSecond, ConversionUsPerSecond);
+		RecordStat(EStat::LockWaitUsPerSecond, LockWaitUs);
+		RecordStat(EStat::UploadedKBps, UploadedKBps);
+		RecordStat(EStat::QueueAgeMs, QueueAgeMs);
+#endif
+		DLB_UE_LOG_BASE(Verbose,
+		                "Video track %s: input %.1f fps rendered %.1f fps dropped %.1f fps coalesced %.1f fps "
+		                "conversion %.0f us/frame %.0f us/s lock wait %.0f us/s upload %.0f KB/s queue age %.2f ms",
+		                *StatsName, InputFps, RenderedFps, DroppedFps, CoalescedFps, ConversionUsPerFrame,
+		                ConversionUsPerSecond, LockWaitUs, UploadedKBps, QueueAgeMs);
+	}
+#endif
+
 	void FVideoSink::handle_frame(const video_frame& VideoFrame)
 	{
 		if (!bIsEnabled)
@@ -90,38 +383,124 @@ namespace DolbyIO
 			return;
 		}
 
-		!Texture ? CreateTexture(VideoFrame.width(), VideoFrame.height())
-		         : ResizeTexture(VideoFrame.width(), VideoFrame.height());
-		Convert(VideoFrame);
-		AsyncTask(ENamedThreads::GameThread, [Tex = this->Texture] { Tex->Render(); });
+		DLB_TRACE_SCOPE("VideoSink::HandleFrame");
+		TRACE_COUNTER_INCREMENT(DolbyIO_VideoFrames);
+		DLB_SCOPED_VIDEO_STAT(HandleFrame);
+		LLM_SCOPE_BYTAG(DolbyIO_VideoBuffers);
+		INC_DWORD_STAT(STAT_DolbyIO_ReceivedFrames);
+		++Counters.ReceivedFrames;
+		if (std::shared_ptr<FEventTraceRecorder> Recorder = std::atomic_load(&TraceRecorder))
+		{
+			Recorder->RecordFrame(VideoTrackID, VideoFrame);
+		}
+
+		SourceWidth = VideoFrame.width();
+		SourceHeight = VideoFrame.height();
+		const int Shift = ClampDownscaleShift(VideoFrame.width(), VideoFrame.height(), DownscaleShift);
+		const FIntPoint Size = GetDownscaledSize(VideoFrame.width(), VideoFrame.height(), Shift);
+		if (!bIsTextureReady)
+		{
+			// Never wait for the game thread here, it may be busy for a long time (e.g. loading a level) and all
+			// video tracks are delivered on the same thread.
+			if (!bIsTextureRequested)
+			{
+				bIsTextureRequested = true;
+				std::shared_ptr<video_frame_buffer> VideoFrameBuffer = VideoFrame.video_frame_buffer();
+				const bool bIsYuv = VideoFrameBuffer && VideoFrameBuffer->type() != video_frame_buffer::type::argb;
+				CreateTexture(Size.X, Size.Y,
+				              bIsYuv && CVarOutputFormat.GetValueOnAnyThread() ==
+				                            static_cast<int32>(EVideoTextureFormat::PlanarYuv)
+				                  ? EVideoTextureFormat::PlanarYuv
+				                  : EVideoTextureFormat::Bgra);
+			}
+			++Counters.DroppedFrames;
+			INC_DWORD_STAT(STAT_DolbyIO_DroppedFrames);
+			return;
+		}
+
+		ResizeTexture(Size.X, Size.Y);
+		DownscaleFactor = 1 << Shift;
+		const uint64 ConversionStart = FPlatformTime::Cycles64();
+		const bool bIsConverted = Convert(VideoFrame, Size.X, Size.Y);
+		const uint64 ConversionEnd = FPlatformTime::Cycles64();
+		Counters.ConversionCycles += ConversionEnd - ConversionStart;
+		if (bIsConverted)
+		{
+			++Counters.ConvertedFrames;
+			RequestRender();
+			Counters.HandOffCycles += FPlatformTime::Cycles64() - ConversionEnd;
+		}
 	}
 
-	void FVideoSink::CreateTexture(int Width, int Height)
+	void FVideoSink::RequestRender()
+	{
+		// A pending direct upload cannot resize the texture and would only drop the frame, so resizes always go through
+		// the game thread. They are rare enough not to need coalescing.
+		if (Texture->IsResizePending())
+		{
+			Texture->MarkRenderPending();
+			AsyncTask(ENamedThreads::GameThread, [Tex = this->Texture] { Tex->Render(); });
+			return;
+		}
+
+		if (!Texture->MarkRenderPending())
+		{
+			++Counters.CoalescedFrames;
+			INC_DWORD_STAT(STAT_DolbyIO_CoalescedFrames);
+			return;
+		}
+
+		// Without a rendering thread, render commands run inline on the enqueuing thread, which must then be the game
+		// thread
+		if (GIsThreadedRendering && CVarDirectUpload.GetValueOnAnyThread())
+		{
+			Texture->EnqueueUpload();
+		}
+		else
+		{
+			AsyncTask(ENamedThreads::GameThread, [Tex = this->Texture] { Tex->Render(); });
+		}
+	}
+
+	void FVideoSink::CreateTexture(int Width, int Height, EVideoTextureFormat Format)
 	{
-		FEvent* TexCreated = FGenericPlatformProcess::GetSynchEventFromPool();
 		AsyncTask(ENamedThreads::GameThread,
-		          [=]
+		          [WeakSink = weak_from_this(), Width, Height, Format]
 		          {
-			          Texture = MakeShared<FVideoTexture>(Width, Height);
-			          TexCreated->Trigger();
+			          std::shared_ptr<FVideoSink> Sink = WeakSink.lock();
+			          if (!Sink)
+			          {
+				          return;
+			          }
 
-			          for (UMaterialInstanceDynamic* Material : Materials)
+			          DLB_SCOPED_VIDEO_STAT(CreateTexture);
+			          Sink->Texture = MakeShared<FVideoTexture, ESPMode::ThreadSafe>(Width, Height, Format);
+			          for (UMaterialInstanceDynamic* Material : Sink->Materials)
 			          {
 				          if (IsValid(Material))
 				          {
-					          Material->SetTextureParameterValue(TexParamName, GetTexture());
+					          BindMaterialImpl(*Material, *Sink->Texture);
 				          }
 			          }
+
+			          FOnTextureCreated OnTexCreated;
+			          {
+				          FScopeLock Lock{&Sink->OnTexCreatedLock};
+				          Sink->bIsTextureReady = true;
+				          Swap(OnTexCreated, Sink->OnTexCreated);
+			          }
+			          if (OnTexCreated)
+			          {
+				          OnTexCreated();
+			          }
+			          DLB_UE_LOG("Created texture %u for video track ID %s %dx%d",
+			                     Sink->Texture->GetTexture()->GetUniqueID(), *Sink->VideoTrackID, Width, Height);
 		          });
-		TexCreated->Wait();
-		FGenericPlatformProcess::ReturnSynchEventToPool(TexCreated);
-		OnTexCreated();
-		DLB_UE_LOG("Created texture %u for video track ID %s %dx%d", GetTexture()->GetUniqueID(), *VideoTrackID, Width,
-		           Height);
 	}
 
 	void FVideoSink::ResizeTexture(int Width, int Height)
 	{
+		DLB_SCOPED_VIDEO_STAT(ResizeTexture);
 		if (Texture->Resize(Width, Height))
 		{
 			AsyncTask(ENamedThreads::GameThread,
@@ -133,13 +512,60 @@ namespace DolbyIO
 		}
 	}
 
-	void FVideoSink::Convert(const video_frame& VideoFrame)
+	bool FVideoSink::IsSameAsPreviousFrame(std::initializer_list<FPlane> Planes, int Width, int Height)
 	{
+		const EFrameHashMode Mode = static_cast<EFrameHashMode>(CVarFrameHashMode.GetValueOnAnyThread());
+		if (Mode != EFrameHashMode::SampledRows && Mode != EFrameHashMode::FullPlanes)
+		{
+			bHasPreviousFrameHash = false;
+			return false;
+		}
+
+		uint64 Hash = (static_cast<uint64>(Width) << 32) | static_cast<uint32>(Height);
+		for (const FPlane& Plane : Planes)
+		{
+			const int Step = Mode == EFrameHashMode::SampledRows ? FMath::Max(Plane.Rows / NumSampledRows, 1) : 1;
+			for (int Row = 0; Row < Plane.Rows; Row += Step)
+			{
+				Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Plane.Data + Row * Plane.Stride),
+				                          Plane.RowBytes, Hash);
+			}
+		}
+
+		const bool bIsSame = bHasPreviousFrameHash && Hash == PreviousFrameHash;
+		PreviousFrameHash = Hash;
+		bHasPreviousFrameHash = true;
+		if (bIsSame)
+		{
+			++Counters.SkippedFrames;
+		}
+		return bIsSame;
+	}
+
+	const uint8* FVideoSink::Downscale(int Plane, const uint8* Data, int& Stride, int BytesPerPixel, int Width,
+	                                   int Height)
+	{
+		if (DownscaleFactor == 1)
+		{
+			return Data;
+		}
+
+		TArray<uint8>& Downscaled = DownscaledPlanes[Plane];
+		const int SrcStride = Stride;
+		Stride = Width * BytesPerPixel;
+		Downscaled.SetNumUninitialized(Stride * Height, false);
+		DecimatePlane(Data, SrcStride, Downscaled.GetData(), Stride, BytesPerPixel, Width, Height, DownscaleFactor);
+		return Downscaled.GetData();
+	}
+
+	bool FVideoSink::Convert(const video_frame& VideoFrame, int Width, int Height)
+	{
+		DLB_SCOPED_VIDEO_STAT(Convert);
 		std::shared_ptr<video_frame_buffer> VideoFrameBuffer = VideoFrame.video_frame_buffer();
 
 		if (!VideoFrameBuffer)
 		{
-			return;
+			return false;
 		}
 
 #if !PLATFORM_MAC
@@ -152,38 +578,108 @@ namespace DolbyIO
 		}
 #endif
 
-		const int Width = VideoFrame.width();
-		const int Height = VideoFrame.height();
 		const int DestStride = Width * FVideoTexture::Stride;
+		const int ChromaWidth = GetChromaSize(Width);
+		const int ChromaHeight = GetChromaSize(Height);
+		const bool bIsPlanar = Texture->GetFormat() == EVideoTextureFormat::PlanarYuv;
+		const FVideoConverter& Converter = GetVideoConverter();
 
-		FScopeLock Lock{Texture->GetBufferLock()};
+		uint8* Buffer = Texture->BeginWrite();
+		bool bIsConverted = false;
 
 		enum video_frame_buffer::type VideoFrameBufferType = VideoFrameBuffer->type();
 
 		if (VideoFrameBufferType == video_frame_buffer::type::argb)
 		{
+			if (bIsPlanar)
+			{
+				// The texture format was chosen based on the first frame, RGB frames cannot be shown in YUV textures
+				++Counters.DroppedFrames;
+				INC_DWORD_STAT(STAT_DolbyIO_DroppedFrames);
+				return false;
+			}
 			if (const video_frame_buffer_argb_interface* FrameARGB = VideoFrameBuffer->get_argb())
 			{
-				video_utils::format_converter::argb_copy(FrameARGB->data(), FrameARGB->stride(), Texture->GetBuffer(),
-				                                         DestStride, Width, Height);
+				int SrcStride = FrameARGB->stride();
+				const uint8* Src = Downscale(0, FrameARGB->data(), SrcStride, FVideoTexture::Stride, Width, Height);
+				if (IsSameAsPreviousFrame({{Src, SrcStride, DestStride, Height}}, Width, Height))
+				{
+					return false;
+				}
+				ConvertInStripes(Width, Height,
+				                 [=](int FirstRow, int NumRows)
+				                 {
+					                 Converter.CopyArgb(Src + FirstRow * SrcStride, SrcStride,
+					                                    Buffer + FirstRow * DestStride, DestStride, Width, NumRows);
+				                 });
+				bIsConverted = true;
 			}
 		}
 		else if (VideoFrameBufferType == video_frame_buffer::type::i420)
 		{
 			if (const video_frame_buffer_i420_interface* FrameI420 = VideoFrameBuffer->get_i420())
 			{
-				video_utils::format_converter::i420_to_argb(
-				    FrameI420->data_y(), FrameI420->stride_y(), FrameI420->data_u(), FrameI420->stride_u(),
-				    FrameI420->data_v(), FrameI420->stride_v(), Texture->GetBuffer(), DestStride, Width, Height);
+				int StrideY = FrameI420->stride_y();
+				int StrideU = FrameI420->stride_u();
+				int StrideV = FrameI420->stride_v();
+				const uint8* DataY = Downscale(0, FrameI420->data_y(), StrideY, 1, Width, Height);
+				const uint8* DataU = Downscale(1, FrameI420->data_u(), StrideU, 1, ChromaWidth, ChromaHeight);
+				const uint8* DataV = Downscale(2, FrameI420->data_v(), StrideV, 1, ChromaWidth, ChromaHeight);
+				if (IsSameAsPreviousFrame({{DataY, StrideY, Width, Height},
+				                           {DataU, StrideU, ChromaWidth, ChromaHeight},
+				                           {DataV, StrideV, ChromaWidth, ChromaHeight}},
+				                          Width, Height))
+				{
+					return false;
+				}
+				if (bIsPlanar)
+				{
+					PackI420(DataY, StrideY, DataU, StrideU, DataV, StrideV, Buffer, Width, Height);
+				}
+				else
+				{
+					ConvertInStripes(
+					    Width, Height,
+					    [=](int FirstRow, int NumRows)
+					    {
+						    const int FirstChromaRow = FirstRow / 2;
+						    Converter.I420ToBgra(DataY + FirstRow * StrideY, StrideY, DataU + FirstChromaRow * StrideU,
+						                         StrideU, DataV + FirstChromaRow * StrideV, StrideV,
+						                         Buffer + FirstRow * DestStride, DestStride, Width, NumRows);
+					    });
+				}
+				bIsConverted = true;
 			}
 		}
 		else if (VideoFrameBufferType == video_frame_buffer::type::nv12)
 		{
 			if (const video_frame_buffer_nv12_interface* FrameNV12 = VideoFrameBuffer->get_nv12())
 			{
-				video_utils::format_converter::nv12_to_argb(FrameNV12->data_y(), FrameNV12->stride_y(),
-				                                            FrameNV12->data_uv(), FrameNV12->stride_uv(),
-				                                            Texture->GetBuffer(), DestStride, Width, Height);
+				int StrideY = FrameNV12->stride_y();
+				int StrideUV = FrameNV12->stride_uv();
+				const uint8* DataY = Downscale(0, FrameNV12->data_y(), StrideY, 1, Width, Height);
+				const uint8* DataUV = Downscale(1, FrameNV12->data_uv(), StrideUV, 2, ChromaWidth, ChromaHeight);
+				if (IsSameAsPreviousFrame(
+				        {{DataY, StrideY, Width, Height}, {DataUV, StrideUV, ChromaWidth * 2, ChromaHeight}}, Width,
+				        Height))
+				{
+					return false;
+				}
+				if (bIsPlanar)
+				{
+					PackNV12(DataY, StrideY, DataUV, StrideUV, Buffer, Width, Height);
+				}
+				else
+				{
+					ConvertInStripes(
+					    Width, Height,
+					    [=](int FirstRow, int NumRows)
+					    {
+						    Converter.NV12ToBgra(DataY + FirstRow * StrideY, StrideY, DataUV + FirstRow / 2 * StrideUV,
+						                         StrideUV, Buffer + FirstRow * DestStride, DestStride, Width, NumRows);
+					    });
+				}
+				bIsConverted = true;
 			}
 		}
 #if PLATFORM_MAC
@@ -213,14 +709,45 @@ namespace DolbyIO
 			if (const video_frame_buffer_native_interface* FrameNative = VideoFrameBuffer->get_native())
 			{
 				FLockedCVPixelBuffer PixelBuffer{FrameNative->cv_pixel_buffer_ref()};
-				video_utils::format_converter::nv12_to_argb(
-				    static_cast<uint8*>(CVPixelBufferGetBaseAddressOfPlane(PixelBuffer, 0)),
-				    CVPixelBufferGetBytesPerRowOfPlane(PixelBuffer, 0),
-				    static_cast<uint8*>(CVPixelBufferGetBaseAddressOfPlane(PixelBuffer, 1)),
-				    CVPixelBufferGetBytesPerRowOfPlane(PixelBuffer, 1), Texture->GetBuffer(), DestStride, Width,
-				    Height);
+				int StrideY = CVPixelBufferGetBytesPerRowOfPlane(PixelBuffer, 0);
+				int StrideUV = CVPixelBufferGetBytesPerRowOfPlane(PixelBuffer, 1);
+				const uint8* PlaneY =
+				    Downscale(0, static_cast<uint8*>(CVPixelBufferGetBaseAddressOfPlane(PixelBuffer, 0)), StrideY, 1,
+				              Width, Height);
+				const uint8* PlaneUV =
+				    Downscale(1, static_cast<uint8*>(CVPixelBufferGetBaseAddressOfPlane(PixelBuffer, 1)), StrideUV, 2,
+				              ChromaWidth, ChromaHeight);
+				if (IsSameAsPreviousFrame(
+				        {{PlaneY, StrideY, Width, Height}, {PlaneUV, StrideUV, ChromaWidth * 2, ChromaHeight}}, Width,
+				        Height))
+				{
+					return false;
+				}
+				if (bIsPlanar)
+				{
+					PackNV12(PlaneY, StrideY, PlaneUV, StrideUV, Buffer, Width, Height);
+				}
+				else
+				{
+					ConvertInStripes(Width, Height,
+					                 [=](int FirstRow, int NumRows)
+					                 {
+						                 Converter.NV12ToBgra(
+						                     PlaneY + FirstRow * StrideY, StrideY, PlaneUV + FirstRow / 2 * StrideUV,
+						                     StrideUV, Buffer + FirstRow * DestStride, DestStride, Width, NumRows);
+					                 });
+				}
+				bIsConverted = true;
 			}
 		}
 #endif
+
+		if (bIsConverted &&
+		    Texture->EndWrite(bIsDirtyRegionUploadEnabled && CVarDirtyRegionUploads.GetValueOnAnyThread()))
+		{
+			++Counters.DroppedFrames;
+			INC_DWORD_STAT(STAT_DolbyIO_DroppedFrames);
+		}
+		return bIsConverted;
 	}
 }
@@ -2,22 +2,53 @@
 
 #pragma once
 
+#include "DolbyIOVideoStats.h"
 #include "Utils/DolbyIOCppSdk.h"
+#include "Utils/DolbyIOPerformance.h"
 
+#include "HAL/CriticalSection.h"
 #include "Templates/SharedPointer.h"
 
+#include <atomic>
+#include <initializer_list>
+#include <memory>
+
 class UMaterialInstanceDynamic;
 class UTexture2D;
+struct FDolbyIOVideoTrackPerformance;
 
 namespace DolbyIO
 {
-	class FVideoSink final : public dolbyio::comms::video_sink
+	enum class EVideoTextureFormat;
+	class FEventTraceRecorder;
+
+	class FVideoSink final : public dolbyio::comms::video_sink, public std::enable_shared_from_this<FVideoSink>
 	{
 		using FOnTextureCreated = TFunction<void(void)>;
 
 	public:
-		FVideoSink(const FString& VideoTrackID);
+		struct FCounters
+		{
+			std::atomic<uint64> ReceivedFrames{0};
+			// Frames whose render request was folded into one already pending for this sink.
+			std::atomic<uint64> CoalescedFrames{0};
+			// Frames overwritten by a newer one before the render thread got to upload them, or received before the
+			// texture was created.
+			std::atomic<uint64> DroppedFrames{0};
+			// Frames identical to the previous one, which were neither converted nor uploaded.
+			std::atomic<uint64> SkippedFrames{0};
+			std::atomic<uint64> ConvertedFrames{0};
+			// Time spent converting frames and handing them over for rendering, in FPlatformTime cycles.
+			std::atomic<uint64> ConversionCycles{0};
+			std::atomic<uint64> HandOffCycles{0};
+		};
+
+		// ParticipantID only serves to tell tracks apart in statistics and performance snapshots
+		FVideoSink(const FString& VideoTrackID, const FString& ParticipantID = "");
+		~FVideoSink();
 
+		// Calls OnTextureCreated right away if the texture already exists, otherwise on the game thread as soon as it
+		// has been created.
 		void OnTextureCreated(FOnTextureCreated OnTextureCreated);
 
 		UTexture2D* GetTexture();
@@ -25,18 +56,110 @@ namespace DolbyIO
 		void UnbindMaterial(UMaterialInstanceDynamic* Material);
 		void UnbindAllMaterials();
 		void Disable();
+		// Upload only the parts of frames which changed, meant for screenshare tracks.
+		void EnableDirtyRegionUploads();
+		// Records received frames while set, may be called from any thread.
+		void SetTraceRecorder(std::shared_ptr<FEventTraceRecorder> Recorder);
+
+		const FCounters& GetCounters() const;
+
+		// Applied by the video memory budget on the game thread. Frames are converted at 1/2^Shift of their
+		// resolution.
+		void SetDownscale(int Shift);
+		int GetDownscaleShift() const;
+		bool HasMaterials() const;
+		const FString& GetParticipantID() const;
+		// Memory taken by the track's frame buffers and textures
+		SIZE_T GetMemorySize() const;
+		// Memory the track would take with the given downscale, 0 until its texture has been created
+		SIZE_T EstimateMemorySize(int Shift) const;
+
+		static constexpr int MaxDownscaleShift = 2;
+		// Cheap enough to be called every frame, rates are refreshed once per second. Only sets the IDs when they
+		// change, so that polling into the same struct does not allocate. Must be called on the game thread.
+		void GetPerformance(double Now, FDolbyIOVideoTrackPerformance& Performance);
+
+#if DLB_VIDEO_STATS
+		// Records the track's rates and costs since the last call as CSV stats and logs them with Verbose verbosity.
+		// Must be called on the game thread.
+		void UpdateStats(double Seconds);
+#endif
 
 	private:
+		struct FPlane
+		{
+			const uint8* Data;
+			int Stride;
+			int RowBytes;
+			int Rows;
+		};
+
 		void handle_frame(const dolbyio::comms::video_frame&) override;
 
-		void CreateTexture(int Width, int Height);
+		void CreateTexture(int Width, int Height, EVideoTextureFormat Format);
 		void ResizeTexture(int Width, int Height);
-		void Convert(const dolbyio::comms::video_frame& VideoFrame);
+		bool Convert(const dolbyio::comms::video_frame& VideoFrame, int Width, int Height);
+		const uint8* Downscale(int Plane, const uint8* Data, int& Stride, int BytesPerPixel, int Width, int Height);
+		bool IsSameAsPreviousFrame(std::initializer_list<FPlane> Planes, int Width, int Height);
+		void RequestRender();
+
+#if DLB_VIDEO_STATS
+		struct FStatsSnapshot
+		{
+			uint64 ReceivedFrames = 0;
+			uint64 DroppedFrames = 0;
+			uint64 CoalescedFrames = 0;
+			uint64 ConvertedFrames = 0;
+			uint64 ConversionCycles = 0;
+			uint64 UploadedFrames = 0;
+			uint64 UploadedBytes = 0;
+			uint64 QueueAgeCycles = 0;
+			uint64 LockWaitCycles = 0;
+		};
+		FStatsSnapshot PreviousStats;
+#if CSV_PROFILER
+		enum class EStat
+		{
+			InputFps,
+			RenderedFps,
+			DroppedFps,
+			CoalescedFps,
+			ConversionUsPerFrame,
+			ConversionUsPerSecond,
+			LockWaitUsPerSecond,
+			UploadedKBps,
+			QueueAgeMs,
+			Num
+		};
+		// Built once per track, since names are never removed from the name table
+		FName StatNames[static_cast<int>(EStat::Num)];
+#endif
+#endif
+
+		FRateMeter InputRate;
+		FRateMeter RenderRate;
+		FRateMeter ConversionRate;
+		FRateMeter ConversionCycleRate;
 
-		TSharedPtr<class FVideoTexture> Texture;
+		TSharedPtr<class FVideoTexture, ESPMode::ThreadSafe> Texture;
 		TSet<UMaterialInstanceDynamic*> Materials;
 		const FString VideoTrackID;
-		FOnTextureCreated OnTexCreated = [] {};
+		const FString ParticipantID;
+		const FString StatsName;
+		FOnTextureCreated OnTexCreated;
+		FCriticalSection OnTexCreatedLock;
+		FCounters Counters;
+		std::shared_ptr<FEventTraceRecorder> TraceRecorder;
+		TArray<uint8> DownscaledPlanes[3];
+		int DownscaleFactor = 1;
+		std::atomic<int> DownscaleShift{0};
+		std::atomic<int> SourceWidth{0};
+		std::atomic<int> SourceHeight{0};
+		uint64 PreviousFrameHash = 0;
+		bool bHasPreviousFrameHash = false;
+		std::atomic<bool> bIsTextureReady{false};
+		bool bIsTextureRequested = false;
+		std::atomic<bool> bIsDirtyRegionUploadEnabled{false};
 		bool bIsEnabled = true;
 	};
 }
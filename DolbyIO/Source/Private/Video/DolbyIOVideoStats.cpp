@@ -0,0 +1,25 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOVideoStats.h"
+
+DEFINE_STAT(STAT_DolbyIO_HandleFrame);
+DEFINE_STAT(STAT_DolbyIO_Convert);
+DEFINE_STAT(STAT_DolbyIO_CreateTexture);
+DEFINE_STAT(STAT_DolbyIO_ResizeTexture);
+DEFINE_STAT(STAT_DolbyIO_Render);
+DEFINE_STAT(STAT_DolbyIO_Upload);
+DEFINE_STAT(STAT_DolbyIO_ReceivedFrames);
+DEFINE_STAT(STAT_DolbyIO_DroppedFrames);
+DEFINE_STAT(STAT_DolbyIO_CoalescedFrames);
+DEFINE_STAT(STAT_DolbyIO_UploadedFrames);
+DEFINE_STAT(STAT_DolbyIO_UploadedBytes);
+DEFINE_STAT(STAT_DolbyIO_VideoMemory);
+DEFINE_STAT(STAT_DolbyIO_VideoMemoryBudget);
+DEFINE_STAT(STAT_DolbyIO_DownscaledTracks);
+DEFINE_STAT(STAT_DolbyIO_TexturePoolHits);
+DEFINE_STAT(STAT_DolbyIO_TexturePoolMisses);
+DEFINE_STAT(STAT_DolbyIO_TexturePoolEvictions);
+DEFINE_STAT(STAT_DolbyIO_PooledTextures);
+DEFINE_STAT(STAT_DolbyIO_PooledTextureMemory);
+
+CSV_DEFINE_CATEGORY(DolbyIO, true);
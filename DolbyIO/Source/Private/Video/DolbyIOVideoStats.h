@@ -0,0 +1,43 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+
+// Per-track video statistics (rates, conversion and upload costs, queue age) are gathered in every build but Shipping,
+// where they can be enabled by defining DLB_VIDEO_STATS=1, e.g. in the project's Target.cs. The stat group and CSV
+// stats additionally need stats and the CSV profiler to be compiled in.
+#ifndef DLB_VIDEO_STATS
+#define DLB_VIDEO_STATS !UE_BUILD_SHIPPING
+#endif
+
+DECLARE_STATS_GROUP(TEXT("DolbyIO"), STATGROUP_DolbyIO, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handle frame"), STAT_DolbyIO_HandleFrame, STATGROUP_DolbyIO, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Convert"), STAT_DolbyIO_Convert, STATGROUP_DolbyIO, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create texture"), STAT_DolbyIO_CreateTexture, STATGROUP_DolbyIO, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Resize texture"), STAT_DolbyIO_ResizeTexture, STATGROUP_DolbyIO, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Render"), STAT_DolbyIO_Render, STATGROUP_DolbyIO, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Upload"), STAT_DolbyIO_Upload, STATGROUP_DolbyIO, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Received frames"), STAT_DolbyIO_ReceivedFrames, STATGROUP_DolbyIO, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Dropped frames"), STAT_DolbyIO_DroppedFrames, STATGROUP_DolbyIO, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Coalesced frames"), STAT_DolbyIO_CoalescedFrames, STATGROUP_DolbyIO, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Uploaded frames"), STAT_DolbyIO_UploadedFrames, STATGROUP_DolbyIO, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Uploaded bytes"), STAT_DolbyIO_UploadedBytes, STATGROUP_DolbyIO, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Video memory"), STAT_DolbyIO_VideoMemory, STATGROUP_DolbyIO, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Video memory budget"), STAT_DolbyIO_VideoMemoryBudget, STATGROUP_DolbyIO, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Downscaled tracks"), STAT_DolbyIO_DownscaledTracks, STATGROUP_DolbyIO, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Texture pool hits"), STAT_DolbyIO_TexturePoolHits, STATGROUP_DolbyIO, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Texture pool misses"), STAT_DolbyIO_TexturePoolMisses, STATGROUP_DolbyIO, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Texture pool evictions"), STAT_DolbyIO_TexturePoolEvictions,
+                                      STATGROUP_DolbyIO, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Pooled textures"), STAT_DolbyIO_PooledTextures, STATGROUP_DolbyIO, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Pooled texture memory"), STAT_DolbyIO_PooledTextureMemory, STATGROUP_DolbyIO, );
+
+CSV_DECLARE_CATEGORY_EXTERN(DolbyIO);
+
+// Times the enclosing scope in both the DolbyIO stat group and the DolbyIO CSV category
+#define DLB_SCOPED_VIDEO_STAT(Name)           \
+	SCOPE_CYCLE_COUNTER(STAT_DolbyIO_##Name); \
+	CSV_SCOPED_TIMING_STAT(DolbyIO, Name)
@@ -2,23 +2,74 @@
 
 #include "DolbyIOVideoTexture.h"
 
+#include "DolbyIOVideoPlanes.h"
+#include "DolbyIOVideoStats.h"
+#include "DolbyIOVideoTexturePool.h"
+#include "Utils/DolbyIOMemory.h"
+
+#include "Async/Async.h"
 #include "Engine/Texture2D.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
 #include "RenderingThread.h"
 #include "Runtime/Launch/Resources/Version.h"
 #include "TextureResource.h"
 
 namespace DolbyIO
 {
-	FVideoTexture::FVideoTexture(int Width, int Height) : Texture(UTexture2D::CreateTransient(Width, Height))
+	namespace
+	{
+		TAutoConsoleVariable<bool> CVarNullTexture{
+		    TEXT("DolbyIO.Video.NullTexture"), false,
+		    TEXT("Whether video textures created from now on convert frames without uploading them to the GPU, so "
+		         "that the video path can run on machines without one, e.g. in load tests. Materials are bound to an "
+		         "empty texture.")};
+
+		FVideoTexture::FUploadCounters TotalCounters;
+
+		UTexture2D* AcquireTexture(bool bIsNull, int Width, int Height, EPixelFormat PixelFormat)
+		{
+			return bIsNull ? FVideoTexture::GetEmptyTexture()
+			               : FVideoTexturePool::Get().Acquire(Width, Height, PixelFormat);
+		}
+	}
+
+	FVideoTexture::FVideoTexture(int Width, int Height, EVideoTextureFormat Format)
+	    : Format(Format), bIsNull(CVarNullTexture.GetValueOnAnyThread()),
+	      Texture(AcquireTexture(bIsNull, Width, Height, Format == EVideoTextureFormat::Bgra ? PF_B8G8R8A8 : PF_G8)),
+	      ChromaTexture(Format == EVideoTextureFormat::PlanarYuv
+	                        ? AcquireTexture(bIsNull, GetChromaSize(Width), GetChromaSize(Height), PF_R8G8)
+	                        : nullptr)
 	{
-		Texture->AddToRoot();
-		Texture->UpdateResource();
 		Resize(Width, Height);
+		TextureWidth = Width;
+		TextureHeight = Height;
 	}
 
 	FVideoTexture::~FVideoTexture()
 	{
-		Texture->RemoveFromRoot();
+		if (bIsNull)
+		{
+			return;
+		}
+
+		// The last reference may be dropped by the render thread or the thread delivering frames
+		auto Release = [Tex = Texture, ChromaTex = ChromaTexture]
+		{
+			FVideoTexturePool::Get().Release(Tex);
+			if (ChromaTex)
+			{
+				FVideoTexturePool::Get().Release(ChromaTex);
+			}
+		};
+		if (IsInGameThread())
+		{
+			Release();
+		}
+		else
+		{
+			AsyncTask(ENamedThreads::GameThread, MoveTemp(Release));
+		}
 	}
 
 	UTexture2D* FVideoTexture::GetTexture()
@@ -26,10 +77,41 @@ namespace DolbyIO
 		return Texture;
 	}
 
-	bool FVideoTexture::Resize(int InWidth, int InHeight)
+	UTexture2D* FVideoTexture::GetChromaTexture()
+	{
+		return ChromaTexture;
+	}
+
+	EVideoTextureFormat FVideoTexture::GetFormat() const
+	{
+		return Format;
+	}
+
+	int FVideoTexture::GetWidth() const
+	{
+		return Width;
+	}
+
+	int FVideoTexture::GetHeight() const
+	{
+		return Height;
+	}
+
+	SIZE_T FVideoTexture::GetMemorySize() const
 	{
-		FScopeLock Lock{&BufferLock};
+		return EstimateMemorySize(TextureWidth, TextureHeight, Format, bIsNull);
+	}
+
+	SIZE_T FVideoTexture::EstimateMemorySize(int Width, int Height, EVideoTextureFormat Format, bool bIsNull)
+	{
+		const SIZE_T FrameSize = Format == EVideoTextureFormat::Bgra ? static_cast<SIZE_T>(Width) * Height * Stride
+		                                                              : GetPlanarFrameSize(Width, Height);
+		// Besides the frame buffers, a texture keeps a CPU copy in its bulk data and the GPU resource
+		return FrameSize * (bIsNull ? NumBuffers : NumBuffers + 2);
+	}
 
+	bool FVideoTexture::Resize(int InWidth, int InHeight)
+	{
 		if (Width == InWidth && Height == InHeight)
 		{
 			return false;
@@ -37,18 +119,113 @@ namespace DolbyIO
 
 		Width = InWidth;
 		Height = InHeight;
-		Buffer.Reserve(Width * Height * Stride);
 		return true;
 	}
 
-	FCriticalSection* FVideoTexture::GetBufferLock()
+	bool FVideoTexture::IsResizePending() const
+	{
+		return Width != TextureWidth || Height != TextureHeight;
+	}
+
+	bool FVideoTexture::MarkRenderPending()
+	{
+		return !bIsRenderPending.exchange(true);
+	}
+
+	uint8* FVideoTexture::BeginWrite()
+	{
+		FFrameBuffer& Buffer = Buffers[WriteIndex];
+		Buffer.Width = Width;
+		Buffer.Height = Height;
+		Buffer.Data.SetNumUninitialized(Format == EVideoTextureFormat::Bgra
+		                                    ? Buffer.Width * Buffer.Height * Stride
+		                                    : GetPlanarFrameSize(Buffer.Width, Buffer.Height));
+		return Buffer.Data.GetData();
+	}
+
+	bool FVideoTexture::EndWrite(bool bDetectDirtyTiles)
+	{
+		FFrameBuffer& Frame = Buffers[WriteIndex];
+		Frame.DirtyTiles.Empty();
+		if (bDetectDirtyTiles && bHasPublished && Format == EVideoTextureFormat::Bgra)
+		{
+			// The previously published buffer is never written to while the current one is, so it can be read here
+			// even if the render thread is uploading it at the same time
+			const FFrameBuffer& Previous = Buffers[PublishedIndex];
+			if (Previous.Width == Frame.Width && Previous.Height == Frame.Height)
+			{
+				DetectDirtyTiles(Previous, Frame);
+
+				// Tiles which changed in a frame that has not been uploaded yet still have to be uploaded with this
+				// one. If the render thread takes the previous frame in the meantime, we upload a bit too much.
+				if (SharedIndex.load(std::memory_order_acquire) & NewFrameBit)
+				{
+					if (Previous.DirtyTiles.Num())
+					{
+						for (TConstSetBitIterator<> It(Previous.DirtyTiles); It; ++It)
+						{
+							Frame.DirtyTiles[It.GetIndex()] = true;
+						}
+					}
+					else
+					{
+						Frame.DirtyTiles.Empty();
+					}
+				}
+			}
+		}
+
+		// Publish the freshly written buffer and take over whichever one was shared until now. If the render thread
+		// has not consumed the previous frame yet, that frame is simply overwritten next time.
+#if DLB_VIDEO_STATS
+		Frame.PublishCycles = FPlatformTime::Cycles64();
+#endif
+		PublishedIndex = WriteIndex;
+		bHasPublished = true;
+		const uint8 PreviousIndex = SharedIndex.exchange(WriteIndex | NewFrameBit, std::memory_order_acq_rel);
+		WriteIndex = PreviousIndex & IndexMask;
+		return PreviousIndex & NewFrameBit;
+	}
+
+	void FVideoTexture::DetectDirtyTiles(const FFrameBuffer& Previous, FFrameBuffer& Frame) const
 	{
-		return &BufferLock;
+		const int TilesX = FMath::DivideAndRoundUp(Frame.Width, TileSize);
+		const int TilesY = FMath::DivideAndRoundUp(Frame.Height, TileSize);
+		const int Pitch = Frame.Width * Stride;
+		Frame.DirtyTiles.Init(false, TilesX * TilesY);
+
+		// Row by row to stay cache friendly, memcmp is vectorized by every C runtime we ship with
+		for (int Y = 0; Y < Frame.Height; ++Y)
+		{
+			const int RowOffset = Y * Pitch;
+			const int TileRow = (Y / TileSize) * TilesX;
+			for (int TileX = 0; TileX < TilesX; ++TileX)
+			{
+				if (Frame.DirtyTiles[TileRow + TileX])
+				{
+					continue;
+				}
+
+				const int X = TileX * TileSize;
+				const int Offset = RowOffset + X * Stride;
+				const int Bytes = FMath::Min(TileSize, Frame.Width - X) * Stride;
+				if (FMemory::Memcmp(Frame.Data.GetData() + Offset, Previous.Data.GetData() + Offset, Bytes))
+				{
+					Frame.DirtyTiles[TileRow + TileX] = true;
+				}
+			}
+		}
 	}
 
-	uint8* FVideoTexture::GetBuffer()
+	const FVideoTexture::FFrameBuffer* FVideoTexture::AcquireLatestFrame()
 	{
-		return Buffer.GetData();
+		if (!(SharedIndex.load(std::memory_order_relaxed) & NewFrameBit))
+		{
+			return nullptr;
+		}
+
+		ReadIndex = SharedIndex.exchange(ReadIndex, std::memory_order_acq_rel) & IndexMask;
+		return &Buffers[ReadIndex];
 	}
 
 	namespace
@@ -62,24 +239,31 @@ namespace DolbyIO
 		class FLockedTexture
 		{
 		public:
-			FLockedTexture(UTexture2D& Tex)
-			    : Tex(Tex), PlatformData(*Tex.PLATFORM_DATA), Mip(PlatformData.Mips[0]),
-			      Buffer(Mip.BulkData.Lock(LOCK_READ_WRITE))
+			FLockedTexture(UTexture2D& Tex, std::atomic<uint64>* LockWaitCycles = nullptr)
+			    : PlatformData(*Tex.PLATFORM_DATA), Mip(PlatformData.Mips[0])
 			{
+#if DLB_VIDEO_STATS
+				const uint64 LockStart = FPlatformTime::Cycles64();
+#endif
+				Buffer = Mip.BulkData.Lock(LOCK_READ_WRITE);
+#if DLB_VIDEO_STATS
+				if (LockWaitCycles)
+				{
+					*LockWaitCycles += FPlatformTime::Cycles64() - LockStart;
+				}
+#endif
 			}
 
 			~FLockedTexture()
 			{
 				Mip.BulkData.Unlock();
-				Tex.UpdateResource();
-				FlushRenderingCommands();
 			}
 
 			void Resize(int Width, int Height)
 			{
 				Mip.SizeX = PlatformData.SizeX = Width;
 				Mip.SizeY = PlatformData.SizeY = Height;
-				Buffer = Mip.BulkData.Realloc(Width * Height * FVideoTexture::Stride);
+				Buffer = Mip.BulkData.Realloc(Width * Height * GPixelFormats[PlatformData.PixelFormat].BlockBytes);
 				Clear();
 			}
 
@@ -89,7 +273,6 @@ namespace DolbyIO
 			}
 
 		private:
-			UTexture2D& Tex;
 			FTexturePlatformData& PlatformData;
 			FTexture2DMipMap& Mip;
 			void* Buffer;
@@ -98,33 +281,207 @@ namespace DolbyIO
 
 	void FVideoTexture::Render()
 	{
-		if (Texture->GetSizeX() != Width || Texture->GetSizeY() != Height)
+		DLB_SCOPED_VIDEO_STAT(Render);
+		const int CurrentWidth = Width;
+		const int CurrentHeight = Height;
+		if (bIsNull)
 		{
-			FLockedTexture Tex{*Texture};
-			Tex.Resize(Width, Height);
+			TextureWidth = CurrentWidth;
+			TextureHeight = CurrentHeight;
+		}
+		else if (Texture->GetSizeX() != CurrentWidth || Texture->GetSizeY() != CurrentHeight)
+		{
+			LLM_SCOPE_BYTAG(DolbyIO_VideoTextures);
+			{
+				// Only keeps the CPU side consistent in case the resource ever gets recreated, the RHI texture is
+				// replaced on the render thread without waiting for it
+				FLockedTexture Tex{*Texture, &Counters.LockWaitCycles};
+				Tex.Resize(CurrentWidth, CurrentHeight);
+			}
+			if (ChromaTexture)
+			{
+				FLockedTexture Tex{*ChromaTexture, &Counters.LockWaitCycles};
+				Tex.Resize(GetChromaSize(CurrentWidth), GetChromaSize(CurrentHeight));
+			}
+			EnqueueResize(CurrentWidth, CurrentHeight);
+			TextureWidth = CurrentWidth;
+			TextureHeight = CurrentHeight;
+		}
+
+		EnqueueUpload();
+	}
+
+	namespace
+	{
+		// Must be called on the render thread
+		void ReplaceRHITexture(UTexture2D& Texture, int NewWidth, int NewHeight, uint8 ClearValue)
+		{
+			FTextureResource* Resource = Texture.GetResource();
+			if (!Resource || !Resource->TextureRHI)
+			{
+				return;
+			}
+
+			const FRHITexture* OldTexture = Resource->TextureRHI;
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1
+			const FRHITextureCreateDesc Desc =
+			    FRHITextureCreateDesc::Create2D(TEXT("DolbyIOVideoTexture"), NewWidth, NewHeight,
+			                                    OldTexture->GetFormat())
+			        .SetFlags(OldTexture->GetFlags());
+			FTexture2DRHIRef NewTexture = RHICreateTexture(Desc);
+#else
+			FRHIResourceCreateInfo CreateInfo{TEXT("DolbyIOVideoTexture")};
+			FTexture2DRHIRef NewTexture = RHICreateTexture2D(NewWidth, NewHeight, OldTexture->GetFormat(), 1, 1,
+			                                                 OldTexture->GetFlags(), CreateInfo);
+#endif
+			const int Pitch = NewWidth * GPixelFormats[OldTexture->GetFormat()].BlockBytes;
+			TArray<uint8> Clear;
+			Clear.Init(ClearValue, Pitch * NewHeight);
+			RHIUpdateTexture2D(NewTexture, 0, FUpdateTextureRegion2D{0, 0, 0, 0, static_cast<uint32>(NewWidth),
+			                                                         static_cast<uint32>(NewHeight)},
+			                   Pitch, Clear.GetData());
+
+			// Materials sample through the texture reference, so repointing it is enough for them to pick up the new
+			// texture. The old one is released once the last command using it has executed.
+			Resource->TextureRHI = NewTexture.GetReference();
+			RHIUpdateTextureReference(Texture.TextureReference.TextureReferenceRHI, NewTexture);
 		}
+	}
+
+	void FVideoTexture::EnqueueResize(int NewWidth, int NewHeight)
+	{
+		ENQUEUE_RENDER_COMMAND(DolbyIOResizeTexture)
+		(
+		    [SharedThis = AsShared(), NewWidth, NewHeight](FRHICommandListImmediate& RHICmdList)
+		    {
+			    LLM_SCOPE_BYTAG(DolbyIO_VideoTextures);
+			    ReplaceRHITexture(*SharedThis->Texture, NewWidth, NewHeight, 0);
+			    if (SharedThis->ChromaTexture)
+			    {
+				    // Neutral chroma, zero would be bright green
+				    ReplaceRHITexture(*SharedThis->ChromaTexture, GetChromaSize(NewWidth), GetChromaSize(NewHeight),
+				                      128);
+			    }
+			    SharedThis->bNeedsFullUpload = true;
+		    });
+	}
 
+	void FVideoTexture::EnqueueUpload()
+	{
 		ENQUEUE_RENDER_COMMAND(DolbyIOUpdateTexture)
 		(
 		    [SharedThis = AsShared()](FRHICommandListImmediate& RHICmdList)
 		    {
-			    FScopeLock Lock{SharedThis->GetBufferLock()};
+			    DLB_SCOPED_VIDEO_STAT(Upload);
+			    // Clear the flag before taking the frame so that frames published from now on trigger a new request
+			    SharedThis->bIsRenderPending = false;
+			    const FFrameBuffer* Frame = SharedThis->AcquireLatestFrame();
+			    if (!Frame)
+			    {
+				    return;
+			    }
+			    if (SharedThis->bIsNull)
+			    {
+				    SharedThis->CountUpload(*Frame, Frame->Data.Num());
+				    return;
+			    }
+
 			    auto FRHITexture2D_Ptr = SharedThis->Texture->GetResource()->GetTexture2DRHI();
-			    uint32 SizeX = FRHITexture2D_Ptr->GetSizeX(), SizeY = FRHITexture2D_Ptr->GetSizeY();	
-			    RHIUpdateTexture2D(FRHITexture2D_Ptr, 0,
-			                       FUpdateTextureRegion2D{0, 0, 0, 0, SizeX, SizeY},
-			                       SizeX * Stride, SharedThis->GetBuffer());
+			    if (!FRHITexture2D_Ptr)
+			    {
+				    // No RHI resource, e.g. when running with -nullrhi
+				    return;
+			    }
+			    uint32 SizeX = FRHITexture2D_Ptr->GetSizeX(), SizeY = FRHITexture2D_Ptr->GetSizeY();
+			    if (static_cast<uint32>(Frame->Width) != SizeX || static_cast<uint32>(Frame->Height) != SizeY)
+			    {
+				    // The frame was written for a size the texture does not have (yet). Frames after it may only
+				    // carry the tiles which changed since this one.
+				    SharedThis->bNeedsFullUpload = true;
+				    return;
+			    }
+
+			    if (SharedThis->Format == EVideoTextureFormat::PlanarYuv)
+			    {
+				    const uint32 ChromaSizeX = GetChromaSize(SizeX);
+				    const uint32 ChromaSizeY = GetChromaSize(SizeY);
+				    RHIUpdateTexture2D(FRHITexture2D_Ptr, 0, FUpdateTextureRegion2D{0, 0, 0, 0, SizeX, SizeY}, SizeX,
+				                       Frame->Data.GetData());
+				    RHIUpdateTexture2D(SharedThis->ChromaTexture->GetResource()->GetTexture2DRHI(), 0,
+				                       FUpdateTextureRegion2D{0, 0, 0, 0, ChromaSizeX, ChromaSizeY}, ChromaSizeX * 2,
+				                       Frame->Data.GetData() + SizeX * SizeY);
+				    SharedThis->CountUpload(*Frame, Frame->Data.Num());
+				    return;
+			    }
+
+			    const uint32 Pitch = SizeX * Stride;
+			    if (SharedThis->bNeedsFullUpload || !Frame->DirtyTiles.Num())
+			    {
+				    SharedThis->bNeedsFullUpload = false;
+				    RHIUpdateTexture2D(FRHITexture2D_Ptr, 0, FUpdateTextureRegion2D{0, 0, 0, 0, SizeX, SizeY}, Pitch,
+				                       Frame->Data.GetData());
+				    SharedThis->CountUpload(*Frame, Frame->Data.Num());
+				    return;
+			    }
+
+			    // One region per horizontal run of dirty tiles
+			    uint64 UploadedBytes = 0;
+			    const int TilesX = FMath::DivideAndRoundUp(Frame->Width, TileSize);
+			    const int TilesY = FMath::DivideAndRoundUp(Frame->Height, TileSize);
+			    for (int TileY = 0; TileY < TilesY; ++TileY)
+			    {
+				    for (int TileX = 0; TileX < TilesX; ++TileX)
+				    {
+					    if (!Frame->DirtyTiles[TileY * TilesX + TileX])
+					    {
+						    continue;
+					    }
+
+					    const int FirstTileX = TileX;
+					    while (TileX + 1 < TilesX && Frame->DirtyTiles[TileY * TilesX + TileX + 1])
+					    {
+						    ++TileX;
+					    }
+
+					    const uint32 X = FirstTileX * TileSize;
+					    const uint32 Y = TileY * TileSize;
+					    const uint32 RegionWidth = FMath::Min<uint32>((TileX + 1) * TileSize, SizeX) - X;
+					    const uint32 RegionHeight = FMath::Min<uint32>(Y + TileSize, SizeY) - Y;
+					    RHIUpdateTexture2D(FRHITexture2D_Ptr, 0,
+					                       FUpdateTextureRegion2D{X, Y, 0, 0, RegionWidth, RegionHeight},
+					                       Pitch, Frame->Data.GetData() + Y * Pitch + X * Stride);
+					    UploadedBytes += RegionWidth * RegionHeight * Stride;
+				    }
+			    }
+			    SharedThis->CountUpload(*Frame, UploadedBytes);
 		    });
 	}
 
+	void FVideoTexture::CountUpload(const FFrameBuffer& Frame, uint64 Bytes)
+	{
+		for (FUploadCounters* UploadCounters : {&Counters, &TotalCounters})
+		{
+			++UploadCounters->Frames;
+			UploadCounters->Bytes += Bytes;
+#if DLB_VIDEO_STATS
+			UploadCounters->QueueAgeCycles += FPlatformTime::Cycles64() - Frame.PublishCycles;
+#endif
+		}
+		INC_DWORD_STAT(STAT_DolbyIO_UploadedFrames);
+		INC_DWORD_STAT_BY(STAT_DolbyIO_UploadedBytes, Bytes);
+	}
+
 	namespace
 	{
 		UTexture2D* CreateEmptyTexture()
 		{
 			UTexture2D* Ret = UTexture2D::CreateTransient(1, 1);
 			Ret->AddToRoot();
-			FLockedTexture Tex{*Ret};
-			Tex.Clear();
+			{
+				FLockedTexture Tex{*Ret};
+				Tex.Clear();
+			}
+			Ret->UpdateResource();
 			return Ret;
 		}
 	}
@@ -134,4 +491,14 @@ namespace DolbyIO
 		static UTexture2D* Ret = CreateEmptyTexture();
 		return Ret;
 	}
+
+	const FVideoTexture::FUploadCounters& FVideoTexture::GetUploadCounters() const
+	{
+		return Counters;
+	}
+
+	const FVideoTexture::FUploadCounters& FVideoTexture::GetTotalUploadCounters()
+	{
+		return TotalCounters;
+	}
 }
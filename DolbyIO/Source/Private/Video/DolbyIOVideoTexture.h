@@ -2,35 +2,122 @@
 
 #pragma once
 
-#include "HAL/CriticalSection.h"
+#include "Containers/Array.h"
+#include "Containers/BitArray.h"
 #include "Templates/SharedPointer.h"
 
+#include <atomic>
+
 class UTexture2D;
 
 namespace DolbyIO
 {
-	class FVideoTexture final : public TSharedFromThis<FVideoTexture>
+	enum class EVideoTextureFormat
+	{
+		// One BGRA texture, converted on the CPU
+		Bgra,
+		// A PF_G8 luma texture and a half resolution PF_R8G8 chroma texture, converted to RGB by the material
+		PlanarYuv,
+	};
+
+	class FVideoTexture final : public TSharedFromThis<FVideoTexture, ESPMode::ThreadSafe>
 	{
 	public:
-		FVideoTexture(int Width, int Height);
+		struct FUploadCounters
+		{
+			std::atomic<uint64> Frames{0};
+			std::atomic<uint64> Bytes{0};
+			// Time frames spent between being published and being uploaded, and time spent waiting for the texture's
+			// bulk data when resizing, in FPlatformTime cycles. Only measured if DLB_VIDEO_STATS is enabled.
+			std::atomic<uint64> QueueAgeCycles{0};
+			std::atomic<uint64> LockWaitCycles{0};
+		};
+
+		FVideoTexture(int Width, int Height, EVideoTextureFormat Format = EVideoTextureFormat::Bgra);
 		~FVideoTexture();
 
+		// In planar YUV format, GetTexture returns the luma texture.
 		UTexture2D* GetTexture();
+		UTexture2D* GetChromaTexture();
+		EVideoTextureFormat GetFormat() const;
+		// Size of the latest frame, which the texture may not have been resized to yet
+		int GetWidth() const;
+		int GetHeight() const;
+		// Memory taken by the frame buffers and the texture, or both textures in planar YUV format, at their current
+		// size
+		SIZE_T GetMemorySize() const;
+		static SIZE_T EstimateMemorySize(int Width, int Height, EVideoTextureFormat Format, bool bIsNull = false);
 
 		bool Resize(int Width, int Height);
-		FCriticalSection* GetBufferLock();
-		uint8* GetBuffer();
+
+		// Producer side of the triple buffer, to be used only by the thread delivering frames. BeginWrite returns a
+		// buffer of the current size which is not visible to the render thread until EndWrite publishes it. EndWrite
+		// returns true if the previously published frame was discarded without ever being uploaded. If
+		// bDetectDirtyTiles is true, the frame is compared with the previous one and only the tiles which changed are
+		// uploaded, which pays off for mostly static content such as screenshares. This is only supported in BGRA
+		// format. In planar YUV format, the buffer is laid out as described in DolbyIOVideoPlanes.h.
+		uint8* BeginWrite();
+		bool EndWrite(bool bDetectDirtyTiles = false);
+
+		bool IsResizePending() const;
+
+		// Returns false if a render request is already pending. That request has not taken a frame yet, so it will
+		// upload whatever was published last.
+		bool MarkRenderPending();
+
+		// Applies a pending resize and uploads the newest frame. Must be called on the game thread.
 		void Render();
+		// Uploads the newest frame without touching the UTexture2D. Can be called from any thread, but only when no
+		// resize is pending.
+		void EnqueueUpload();
 
 		static UTexture2D* GetEmptyTexture();
+		// Textures created while DolbyIO.Video.NullTexture is set count the frames they would have uploaded.
+		const FUploadCounters& GetUploadCounters() const;
+		// Totals over all video textures
+		static const FUploadCounters& GetTotalUploadCounters();
 
 		static constexpr int Stride = 4;
 
 	private:
+		struct FFrameBuffer
+		{
+			TArray<uint8> Data;
+			// One bit per tile which differs from the last frame uploaded, empty if the whole frame must be uploaded.
+			TBitArray<> DirtyTiles;
+			int Width = 0;
+			int Height = 0;
+			uint64 PublishCycles = 0;
+		};
+
+		const FFrameBuffer* AcquireLatestFrame();
+		void DetectDirtyTiles(const FFrameBuffer& Previous, FFrameBuffer& Frame) const;
+		void EnqueueResize(int NewWidth, int NewHeight);
+		void CountUpload(const FFrameBuffer& Frame, uint64 Bytes);
+
+		static constexpr int TileSize = 64;
+		static constexpr int NumBuffers = 3;
+
+		static constexpr uint8 IndexMask = 0b011;
+		static constexpr uint8 NewFrameBit = 0b100;
+
+		const EVideoTextureFormat Format;
+		// Null textures take frames without uploading them and hand out the empty texture
+		const bool bIsNull;
 		UTexture2D* const Texture;
-		TArray<uint8> Buffer;
-		FCriticalSection BufferLock;
-		int Width;
-		int Height;
+		UTexture2D* const ChromaTexture;
+		FFrameBuffer Buffers[NumBuffers];
+		std::atomic<uint8> SharedIndex{1};
+		uint8 WriteIndex = 0;
+		uint8 ReadIndex = 2;
+		uint8 PublishedIndex = 1;
+		bool bHasPublished = false;
+		bool bNeedsFullUpload = true; // render thread only
+		std::atomic<int> Width{0};
+		std::atomic<int> Height{0};
+		std::atomic<int> TextureWidth{0};
+		std::atomic<int> TextureHeight{0};
+		std::atomic<bool> bIsRenderPending{false};
+		FUploadCounters Counters;
 	};
 }
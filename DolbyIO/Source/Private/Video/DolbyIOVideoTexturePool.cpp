@@ -0,0 +1,160 @@
+// Copyright 2023 Dolby Laboratories
+
+#include "DolbyIOVideoTexturePool.h"
+
+#include "DolbyIOVideoStats.h"
+#include "Utils/DolbyIOMemory.h"
+
+#include "Engine/Texture2D.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderingThread.h"
+#include "TextureResource.h"
+
+namespace DolbyIO
+{
+	namespace
+	{
+		TAutoConsoleVariable<int32> CVarMaxPoolSize{
+		    TEXT("DolbyIO.Video.TexturePool.MaxSize"), 8,
+		    TEXT("Maximum number of unused video textures kept for reuse. 0 disables pooling.")};
+
+		TAutoConsoleVariable<int32> CVarMaxPoolMemoryMB{
+		    TEXT("DolbyIO.Video.TexturePool.MaxMemoryMB"), 64,
+		    TEXT("Maximum amount of memory in MB used by unused video textures kept for reuse.")};
+
+		SIZE_T GetTextureBytes(int Width, int Height, EPixelFormat PixelFormat)
+		{
+			return static_cast<SIZE_T>(Width) * Height * GPixelFormats[PixelFormat].BlockBytes;
+		}
+
+		void ClearTexture(UTexture2D* Texture, int Width, int Height, EPixelFormat PixelFormat)
+		{
+			ENQUEUE_RENDER_COMMAND(DolbyIOClearTexture)
+			(
+			    [Texture, Width, Height, PixelFormat](FRHICommandListImmediate& RHICmdList)
+			    {
+				    FTextureResource* Resource = Texture->GetResource();
+				    if (!Resource || !Resource->TextureRHI)
+				    {
+					    return;
+				    }
+
+				    // Two channel textures only hold chroma planes, for which zero would be bright green
+				    const uint32 Pitch = Width * GPixelFormats[PixelFormat].BlockBytes;
+				    TArray<uint8> Clear;
+				    Clear.Init(PixelFormat == PF_R8G8 ? 128 : 0, Pitch * Height);
+				    RHIUpdateTexture2D(Resource->GetTexture2DRHI(), 0,
+				                       FUpdateTextureRegion2D{0, 0, 0, 0, static_cast<uint32>(Width),
+				                                              static_cast<uint32>(Height)},
+				                       Pitch, Clear.GetData());
+			    });
+		}
+	}
+
+	FVideoTexturePool& FVideoTexturePool::Get()
+	{
+		static FVideoTexturePool Pool;
+		return Pool;
+	}
+
+	UTexture2D* FVideoTexturePool::Acquire(int Width, int Height, EPixelFormat PixelFormat)
+	{
+		check(IsInGameThread());
+		LLM_SCOPE_BYTAG(DolbyIO_VideoTextures);
+		for (int i = Entries.Num() - 1; i >= 0; --i)
+		{
+			const FEntry& Entry = Entries[i];
+			if (Entry.Width == Width && Entry.Height == Height && Entry.PixelFormat == PixelFormat)
+			{
+				UTexture2D* Texture = Entry.Texture;
+				--Stats.NumPooled;
+				Stats.PooledBytes -= Entry.Bytes;
+				DEC_DWORD_STAT(STAT_DolbyIO_PooledTextures);
+				DEC_MEMORY_STAT_BY(STAT_DolbyIO_PooledTextureMemory, Entry.Bytes);
+				Entries.RemoveAt(i);
+				++Stats.Hits;
+				INC_DWORD_STAT(STAT_DolbyIO_TexturePoolHits);
+				// Whatever was shown last by the previous owner must not flash on screen
+				ClearTexture(Texture, Width, Height, PixelFormat);
+				return Texture;
+			}
+		}
+
+		++Stats.Misses;
+		INC_DWORD_STAT(STAT_DolbyIO_TexturePoolMisses);
+		UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, PixelFormat);
+		// Only color textures hold gamma encoded data, video planes are sampled as they are
+		Texture->SRGB = PixelFormat == PF_B8G8R8A8;
+		Texture->AddToRoot();
+		Texture->UpdateResource();
+		return Texture;
+	}
+
+	void FVideoTexturePool::Release(UTexture2D* Texture)
+	{
+		check(IsInGameThread());
+		if (!NumUsers)
+		{
+			// Released after the last subsystem went away, e.g. by a video track destroyed with it
+			Texture->RemoveFromRoot();
+			return;
+		}
+
+		const int Width = Texture->GetSizeX();
+		const int Height = Texture->GetSizeY();
+		const EPixelFormat PixelFormat = Texture->GetPixelFormat();
+		Entries.Add(FEntry{Texture, Width, Height, PixelFormat, GetTextureBytes(Width, Height, PixelFormat)});
+		++Stats.NumPooled;
+		Stats.PooledBytes += Entries.Last().Bytes;
+		INC_DWORD_STAT(STAT_DolbyIO_PooledTextures);
+		INC_MEMORY_STAT_BY(STAT_DolbyIO_PooledTextureMemory, Entries.Last().Bytes);
+
+		const int MaxSize = FMath::Max(CVarMaxPoolSize.GetValueOnGameThread(), 0);
+		const SIZE_T MaxBytes = static_cast<SIZE_T>(FMath::Max(CVarMaxPoolMemoryMB.GetValueOnGameThread(), 0)) << 20;
+		while (Entries.Num() && (Entries.Num() > MaxSize || Stats.PooledBytes > MaxBytes))
+		{
+			Evict(0);
+			++Stats.Evictions;
+			INC_DWORD_STAT(STAT_DolbyIO_TexturePoolEvictions);
+		}
+	}
+
+	void FVideoTexturePool::AddUser()
+	{
+		check(IsInGameThread());
+		++NumUsers;
+	}
+
+	void FVideoTexturePool::RemoveUser()
+	{
+		check(IsInGameThread());
+		check(NumUsers > 0);
+		if (--NumUsers == 0)
+		{
+			Empty();
+		}
+	}
+
+	void FVideoTexturePool::Empty()
+	{
+		while (Entries.Num())
+		{
+			Evict(Entries.Num() - 1);
+		}
+	}
+
+	const FVideoTexturePool::FStats& FVideoTexturePool::GetStats() const
+	{
+		return Stats;
+	}
+
+	void FVideoTexturePool::Evict(int Index)
+	{
+		--Stats.NumPooled;
+		Stats.PooledBytes -= Entries[Index].Bytes;
+		DEC_DWORD_STAT(STAT_DolbyIO_PooledTextures);
+		DEC_MEMORY_STAT_BY(STAT_DolbyIO_PooledTextureMemory, Entries[Index].Bytes);
+		Entries[Index].Texture->RemoveFromRoot();
+		Entries.RemoveAt(Index);
+	}
+}
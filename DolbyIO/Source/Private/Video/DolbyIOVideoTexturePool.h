@@ -0,0 +1,58 @@
+// Copyright 2023 Dolby Laboratories
+
+#pragma once
+
+#include "Containers/Array.h"
+#include "PixelFormat.h"
+
+class UTexture2D;
+
+namespace DolbyIO
+{
+	// Keeps textures of video tracks which went away so that tracks added later with the same resolution and pixel
+	// format can reuse them instead of creating and garbage collecting new ones. Textures are only kept while a
+	// subsystem uses the pool, the pool is emptied when the last one goes away. Must be used on the game thread only.
+	class FVideoTexturePool final
+	{
+	public:
+		struct FStats
+		{
+			uint64 Hits = 0;
+			uint64 Misses = 0;
+			// Textures destroyed because the pool was full or over its memory cap when they were released.
+			uint64 Evictions = 0;
+			int NumPooled = 0;
+			SIZE_T PooledBytes = 0;
+		};
+
+		static FVideoTexturePool& Get();
+
+		// Returns a rooted texture of the given size and format, cleared to black.
+		UTexture2D* Acquire(int Width, int Height, EPixelFormat PixelFormat = PF_B8G8R8A8);
+		// Takes back a texture obtained from Acquire, which may have been resized in the meantime.
+		void Release(UTexture2D* Texture);
+
+		void AddUser();
+		void RemoveUser();
+
+		const FStats& GetStats() const;
+
+	private:
+		struct FEntry
+		{
+			UTexture2D* Texture;
+			int Width;
+			int Height;
+			EPixelFormat PixelFormat;
+			SIZE_T Bytes;
+		};
+
+		void Empty();
+		void Evict(int Index);
+
+		// Least recently released first
+		TArray<FEntry> Entries;
+		FStats Stats;
+		int NumUsers = 0;
+	};
+}
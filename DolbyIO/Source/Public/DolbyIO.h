@@ -8,6 +8,7 @@
 #include "DolbyIOCppSdkFwd.h"
 #include "DolbyIOTypes.h"
 
+#include <atomic>
 #include <memory>
 
 #include "DolbyIO.generated.h"
@@ -145,22 +146,168 @@ const FDolbyIOParticipantInfo&, ParticipantInfo);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam
 (FDolbyIOOnErrorDelegate,
 const FString&, ErrorMsg);
+
+// Native counterparts of the delegates above, for C++ listeners which do not need reflection
+DECLARE_MULTICAST_DELEGATE
+(FDolbyIOOnTokenNeededNativeDelegate);
+
+DECLARE_MULTICAST_DELEGATE
+(FDolbyIOOnInitializedNativeDelegate);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnConnectedNativeDelegate,
+const FString&,
+const FString&);
+
+DECLARE_MULTICAST_DELEGATE
+(FDolbyIOOnDisconnectedNativeDelegate);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnParticipantAddedNativeDelegate,
+const EDolbyIOParticipantStatus,
+const FDolbyIOParticipantInfo&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnParticipantUpdatedNativeDelegate,
+const EDolbyIOParticipantStatus,
+const FDolbyIOParticipantInfo&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnRemoteParticipantConnectedNativeDelegate,
+const FDolbyIOParticipantInfo&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnRemoteParticipantDisconnectedNativeDelegate,
+const FDolbyIOParticipantInfo&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnLocalParticipantUpdatedNativeDelegate,
+const EDolbyIOParticipantStatus,
+const FDolbyIOParticipantInfo&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnVideoTrackAddedNativeDelegate,
+const FDolbyIOVideoTrack&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnVideoTrackRemovedNativeDelegate,
+const FDolbyIOVideoTrack&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnVideoTrackEnabledNativeDelegate,
+const FDolbyIOVideoTrack&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnVideoTrackDisabledNativeDelegate,
+const FDolbyIOVideoTrack&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnVideoEnabledNativeDelegate,
+const FString&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnVideoDisabledNativeDelegate,
+const FString&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnScreenshareStartedNativeDelegate,
+const FString&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnScreenshareStoppedNativeDelegate,
+const FString&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnActiveSpeakersChangedNativeDelegate,
+const TArray<FString>&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnAudioLevelsChangedNativeDelegate,
+const TArray<FString>&,
+const TArray<float>&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnScreenshareSourcesReceivedNativeDelegate,
+const TArray<FDolbyIOScreenshareSource>&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnCurrentScreenshareSourceReceivedNativeDelegate,
+bool,
+const FDolbyIOScreenshareSource&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnAudioInputDevicesReceivedNativeDelegate,
+const TArray<FDolbyIOAudioDevice>&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnAudioOutputDevicesReceivedNativeDelegate,
+const TArray<FDolbyIOAudioDevice>&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnCurrentAudioInputDeviceReceivedNativeDelegate,
+bool,
+const FDolbyIOAudioDevice&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnCurrentAudioOutputDeviceReceivedNativeDelegate,
+bool,
+const FDolbyIOAudioDevice&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnVideoDevicesReceivedNativeDelegate,
+const TArray<FDolbyIOVideoDevice>&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnCurrentVideoDeviceReceivedNativeDelegate,
+bool,
+const FDolbyIOVideoDevice&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnCurrentAudioInputDeviceChangedNativeDelegate,
+bool,
+const FDolbyIOAudioDevice&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnCurrentAudioOutputDeviceChangedNativeDelegate,
+bool,
+const FDolbyIOAudioDevice&);
+
+DECLARE_MULTICAST_DELEGATE_TwoParams
+(FDolbyIOOnMessageReceivedNativeDelegate,
+const FString&,
+const FDolbyIOParticipantInfo&);
+
+DECLARE_MULTICAST_DELEGATE_OneParam
+(FDolbyIOOnErrorNativeDelegate,
+const FString&);
 // clang-format on
 
 namespace DolbyIO
 {
+	class FAudioLevelTable;
 	class FDevices;
 	class FErrorHandler;
+	class FEventQueue;
+	class FEventTracePlayer;
+	class FEventTraceRecorder;
+	class FLocalBackend;
+	struct FPerformanceCounters;
 	class FVideoFrameHandler;
 	class FVideoSink;
 }
 
+class UDolbyIOObserver;
+
 UCLASS(DisplayName = "Dolby.io Subsystem")
 class DOLBYIO_API UDolbyIOSubsystem : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
 
+	friend class DolbyIO::FDevices;
 	friend class DolbyIO::FErrorHandler;
+	friend class DolbyIO::FEventTracePlayer;
+	friend class DolbyIO::FLocalBackend;
+	friend class UDolbyIOObserver;
 
 public:
 	UFUNCTION(BlueprintCallable, Category = "Dolby.io Comms")
@@ -232,6 +379,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Dolby.io Comms")
 	TArray<FDolbyIOParticipantInfo> GetParticipants();
 
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Comms")
+	float GetAudioLevel(const FString& ParticipantID);
+
 	UFUNCTION(BlueprintCallable, Category = "Dolby.io Comms", Meta = (AutoCreateRefTerm = "VideoDevice"))
 	void EnableVideo(const FDolbyIOVideoDevice& VideoDevice, bool bBlurBackground = false);
 	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Comms")
@@ -389,6 +539,10 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Comms")
 	FDolbyIOOnErrorDelegate OnSendMessageError;
 
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Comms")
+	FDolbyIOPerformanceSnapshot GetPerformanceSnapshot();
+	void UpdatePerformanceSnapshot(FDolbyIOPerformanceSnapshot& Snapshot);
+
 	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Comms")
 	FDolbyIOOnTokenNeededDelegate OnTokenNeeded;
 	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Comms")
@@ -416,11 +570,84 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Dolby.io Comms")
 	FDolbyIOOnMessageReceivedDelegate OnMessageReceived;
 
+	// Native counterparts of the events above, broadcast on the game thread before them. Binding to these instead of
+	// the Blueprint events avoids going through reflection.
+	FDolbyIOOnInitializedNativeDelegate OnInitializedNative;
+	FDolbyIOOnErrorNativeDelegate OnSetTokenErrorNative;
+	FDolbyIOOnConnectedNativeDelegate OnConnectedNative;
+	FDolbyIOOnErrorNativeDelegate OnConnectErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnDemoConferenceErrorNative;
+	FDolbyIOOnDisconnectedNativeDelegate OnDisconnectedNative;
+	FDolbyIOOnErrorNativeDelegate OnDisconnectErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnSetSpatialEnvironmentScaleErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnMuteInputErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnUnmuteInputErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnMuteOutputErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnUnmuteOutputErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnMuteParticipantErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnUnmuteParticipantErrorNative;
+	FDolbyIOOnVideoEnabledNativeDelegate OnVideoEnabledNative;
+	FDolbyIOOnErrorNativeDelegate OnEnableVideoErrorNative;
+	FDolbyIOOnVideoDisabledNativeDelegate OnVideoDisabledNative;
+	FDolbyIOOnErrorNativeDelegate OnDisableVideoErrorNative;
+	FDolbyIOOnScreenshareSourcesReceivedNativeDelegate OnScreenshareSourcesReceivedNative;
+	FDolbyIOOnErrorNativeDelegate OnGetScreenshareSourcesErrorNative;
+	FDolbyIOOnScreenshareStartedNativeDelegate OnScreenshareStartedNative;
+	FDolbyIOOnErrorNativeDelegate OnStartScreenshareErrorNative;
+	FDolbyIOOnScreenshareStoppedNativeDelegate OnScreenshareStoppedNative;
+	FDolbyIOOnErrorNativeDelegate OnStopScreenshareErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnChangeScreenshareParametersErrorNative;
+	FDolbyIOOnCurrentScreenshareSourceReceivedNativeDelegate OnCurrentScreenshareSourceReceivedNative;
+	FDolbyIOOnErrorNativeDelegate OnGetCurrentScreenshareSourceErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnSetLocalPlayerLocationErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnSetLocalPlayerRotationErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnSetRemotePlayerLocationErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnSetLogSettingsErrorNative;
+	FDolbyIOOnAudioInputDevicesReceivedNativeDelegate OnAudioInputDevicesReceivedNative;
+	FDolbyIOOnErrorNativeDelegate OnGetAudioInputDevicesErrorNative;
+	FDolbyIOOnAudioOutputDevicesReceivedNativeDelegate OnAudioOutputDevicesReceivedNative;
+	FDolbyIOOnErrorNativeDelegate OnGetAudioOutputDevicesErrorNative;
+	FDolbyIOOnCurrentAudioInputDeviceReceivedNativeDelegate OnCurrentAudioInputDeviceReceivedNative;
+	FDolbyIOOnErrorNativeDelegate OnGetCurrentAudioInputDeviceErrorNative;
+	FDolbyIOOnCurrentAudioOutputDeviceReceivedNativeDelegate OnCurrentAudioOutputDeviceReceivedNative;
+	FDolbyIOOnErrorNativeDelegate OnGetCurrentAudioOutputDeviceErrorNative;
+	FDolbyIOOnCurrentAudioInputDeviceChangedNativeDelegate OnCurrentAudioInputDeviceChangedNative;
+	FDolbyIOOnErrorNativeDelegate OnSetAudioInputDeviceErrorNative;
+	FDolbyIOOnCurrentAudioOutputDeviceChangedNativeDelegate OnCurrentAudioOutputDeviceChangedNative;
+	FDolbyIOOnErrorNativeDelegate OnSetAudioOutputDeviceErrorNative;
+	FDolbyIOOnVideoDevicesReceivedNativeDelegate OnVideoDevicesReceivedNative;
+	FDolbyIOOnErrorNativeDelegate OnGetVideoDevicesErrorNative;
+	FDolbyIOOnCurrentVideoDeviceReceivedNativeDelegate OnCurrentVideoDeviceReceivedNative;
+	FDolbyIOOnErrorNativeDelegate OnGetCurrentVideoDeviceErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnUpdateUserMetadataErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnSetAudioCaptureModeErrorNative;
+	FDolbyIOOnErrorNativeDelegate OnSendMessageErrorNative;
+	FDolbyIOOnTokenNeededNativeDelegate OnTokenNeededNative;
+	FDolbyIOOnParticipantAddedNativeDelegate OnParticipantAddedNative;
+	FDolbyIOOnParticipantUpdatedNativeDelegate OnParticipantUpdatedNative;
+	FDolbyIOOnRemoteParticipantConnectedNativeDelegate OnRemoteParticipantConnectedNative;
+	FDolbyIOOnRemoteParticipantDisconnectedNativeDelegate OnRemoteParticipantDisconnectedNative;
+	FDolbyIOOnLocalParticipantUpdatedNativeDelegate OnLocalParticipantUpdatedNative;
+	FDolbyIOOnVideoTrackAddedNativeDelegate OnVideoTrackAddedNative;
+	FDolbyIOOnVideoTrackRemovedNativeDelegate OnVideoTrackRemovedNative;
+	FDolbyIOOnVideoTrackEnabledNativeDelegate OnVideoTrackEnabledNative;
+	FDolbyIOOnVideoTrackDisabledNativeDelegate OnVideoTrackDisabledNative;
+	FDolbyIOOnActiveSpeakersChangedNativeDelegate OnActiveSpeakersChangedNative;
+	FDolbyIOOnAudioLevelsChangedNativeDelegate OnAudioLevelsChangedNative;
+	FDolbyIOOnMessageReceivedNativeDelegate OnMessageReceivedNative;
+
+	// Records the SDK events handled by the subsystem to a file, which can be replayed to reproduce them as a
+	// benchmark. Traces can only be played with the local backend or before the SDK is initialized. Also available as
+	// the DolbyIO.Trace.* console commands.
+	void StartTraceRecording(const FString& Path, bool bRecordFramePayloads = false);
+	void StopTraceRecording();
+	void PlayTrace(const FString& Path, float Speed = 1.0f);
+
 private:
 	void Initialize(FSubsystemCollectionBase&) override;
 	void Deinitialize() override;
 
-	bool CanConnect(const FDolbyIOOnErrorDelegate&) const;
+	bool CanConnect(const FDolbyIOOnErrorDelegate&, const FDolbyIOOnErrorNativeDelegate&) const;
 	bool IsConnected() const;
 	bool IsConnectedAsActive() const;
 	bool IsSpatialAudio() const;
@@ -432,6 +659,8 @@ private:
 	void ToggleInputMute();
 	void ToggleOutputMute();
 
+	template <class TDelegate, class TNativeDelegate, class... TArgs>
+	void BroadcastEvent(TDelegate& Event, TNativeDelegate& NativeEvent, TArgs&&... Args) const;
 	void BroadcastRemoteParticipantConnectedIfNecessary(const FDolbyIOParticipantInfo& ParticipantInfo);
 	void BroadcastRemoteParticipantDisconnectedIfNecessary(const FDolbyIOParticipantInfo& ParticipantInfo);
 
@@ -439,6 +668,10 @@ private:
 	void BroadcastVideoTrackEnabled(const FDolbyIOVideoTrack& VideoTrack);
 	void ProcessBufferedVideoTracks(const FString& ParticipantID);
 	void WarnIfVideoTrackSuspicious(const FString& VideoTrackID);
+	void UpdateVideoStats();
+	void ApplyVideoMemoryBudget();
+	void PublishVideoSinks();
+	void UpdateListeners();
 
 	void SetLocationUsingFirstPlayer();
 	void SetLocalPlayerLocationImpl(const FVector& Location);
@@ -449,6 +682,7 @@ private:
 	void Handle(const dolbyio::comms::audio_device_changed&);
 	void Handle(const dolbyio::comms::audio_levels&);
 	void Handle(const dolbyio::comms::conference_message_received&);
+	void Handle(const dolbyio::comms::conference_status_updated&);
 	void Handle(const dolbyio::comms::local_participant_updated&);
 	void Handle(const dolbyio::comms::remote_participant_added&);
 	void Handle(const dolbyio::comms::remote_participant_updated&);
@@ -456,11 +690,16 @@ private:
 	void Handle(const dolbyio::comms::remote_video_track_removed&);
 	void Handle(const dolbyio::comms::screen_share_error&);
 	void Handle(const dolbyio::comms::utils::vfs_event&);
+	template <class TEvent> void HandleAndRecord(const TEvent&);
 
 	UDolbyIOSubsystem& GetSubsystem()
 	{
 		return *this;
 	}
+	const UDolbyIOSubsystem& GetSubsystem() const
+	{
+		return *this;
+	}
 
 	dolbyio::comms::conference_status ConferenceStatus;
 	FString LocalParticipantID;
@@ -469,18 +708,45 @@ private:
 	EDolbyIOSpatialAudioStyle SpatialAudioStyle;
 	TMap<FString, TArray<FDolbyIOVideoTrack>> BufferedAddedVideoTracks;
 	TMap<FString, TArray<FDolbyIOVideoTrack>> BufferedEnabledVideoTracks;
+	FCriticalSection BufferedVideoTracksLock;
 
 	TMap<FString, FDolbyIOParticipantInfo> RemoteParticipants;
 	FCriticalSection RemoteParticipantsLock;
 
+	TSet<FString> ActiveSpeakerIDs;
+	FCriticalSection ActiveSpeakersLock;
+
+	// Whether anything listens to the events whose payloads are only built for listeners. Refreshed on the game thread
+	// before the events are dispatched and read by the handlers, which assume listeners until the first refresh.
+	std::atomic<bool> bHasActiveSpeakersListeners{true};
+	std::atomic<bool> bHasAudioLevelsListeners{true};
+	std::atomic<bool> bHasParticipantUpdatedListeners{true};
+	TArray<TWeakObjectPtr<UDolbyIOObserver>> Observers;
+
+	// Last locations set on the game thread, which the video memory budget uses to tell far away participants
+	FVector LocalPlayerLocation = FVector::ZeroVector;
+	TMap<FString, FVector> RemotePlayerLocations;
+	SIZE_T VideoMemoryBudget = 0;
+
 	TMap<FString, std::shared_ptr<DolbyIO::FVideoSink>> VideoSinks;
 	FCriticalSection VideoSinksLock;
+	// Copy of the sinks republished under VideoSinksLock whenever they change, so that performance snapshots polled
+	// every frame can walk them without locking
+	std::shared_ptr<const TArray<std::shared_ptr<DolbyIO::FVideoSink>>> PublishedVideoSinks;
+
+	// Declared before the SDK so that they outlive the threads pushing events and audio levels to them
+	TSharedPtr<DolbyIO::FEventQueue> EventQueue;
+	TSharedPtr<DolbyIO::FAudioLevelTable> AudioLevelTable;
 
 	std::shared_ptr<dolbyio::comms::plugin::video_processor> VideoProcessor;
 	std::shared_ptr<DolbyIO::FVideoFrameHandler> LocalCameraFrameHandler;
 	std::shared_ptr<DolbyIO::FVideoFrameHandler> LocalScreenshareFrameHandler;
 	TSharedPtr<DolbyIO::FDevices> Devices;
 	TSharedPtr<dolbyio::comms::sdk> Sdk;
+	TSharedPtr<DolbyIO::FLocalBackend> LocalBackend;
+	std::shared_ptr<DolbyIO::FEventTraceRecorder> TraceRecorder;
+	TSharedPtr<DolbyIO::FEventTracePlayer> TracePlayer;
+	TSharedPtr<DolbyIO::FPerformanceCounters> PerformanceCounters;
 	TSharedPtr<dolbyio::comms::refresh_token> RefreshTokenCb;
 
 	float SpatialEnvironmentScale = 1.0f;
@@ -491,9 +757,13 @@ private:
 
 	FTimerHandle LocationTimerHandle;
 	FTimerHandle RotationTimerHandle;
+	FTimerHandle VideoStatsTimerHandle;
+	FTimerHandle VideoMemoryBudgetTimerHandle;
 
 	static constexpr auto LocalCameraTrackID = "local-camera";
 	static constexpr auto LocalScreenshareTrackID = "local-screenshare";
+	static constexpr float VideoStatsInterval = 1.f;
+	static constexpr float VideoMemoryBudgetInterval = 0.5f;
 };
 
 UCLASS(ClassGroup = "Dolby.io Comms",
@@ -503,6 +773,8 @@ class DOLBYIO_API UDolbyIOObserver : public UActorComponent
 {
 	GENERATED_BODY()
 
+	friend class UDolbyIOSubsystem;
+
 public:
 	UDolbyIOObserver()
 	{
@@ -770,217 +1042,168 @@ public:
 
 private:
 	void InitializeComponent() override;
-
-#define DLB_DEFINE_FORWARDER(Event, ...) \
-	{                                    \
-		Event.Broadcast(__VA_ARGS__);    \
+	void UninitializeComponent() override;
+	// Forwards the events whose payloads are only built for listeners while something is bound to them here, so that
+	// the observer does not count as a listener of events nobody handles through it
+	void UpdateListenedBindings();
+
+	TWeakObjectPtr<UDolbyIOSubsystem> Subsystem;
+	FDelegateHandle OnActiveSpeakersChangedHandle;
+	FDelegateHandle OnAudioLevelsChangedHandle;
+	FDelegateHandle OnParticipantUpdatedHandle;
+
+#define DLB_DEFINE_FORWARDER(Event, ...)  \
+	{                                     \
+		if (Event.IsBound())              \
+		{                                 \
+			Event.Broadcast(__VA_ARGS__); \
+		}                                 \
 	}
 
-	UFUNCTION()
 	void FwdOnTokenNeeded() DLB_DEFINE_FORWARDER(OnTokenNeeded);
 
-	UFUNCTION() void FwdOnInitialized() DLB_DEFINE_FORWARDER(OnInitialized);
-	UFUNCTION() void FwdOnSetTokenError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnSetTokenError, ErrorMsg);
+	void FwdOnInitialized() DLB_DEFINE_FORWARDER(OnInitialized);
+	void FwdOnSetTokenError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnSetTokenError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnConnected(const FString& LocalParticipantID, const FString& ConferenceID)
 	    DLB_DEFINE_FORWARDER(OnConnected, LocalParticipantID, ConferenceID);
-	UFUNCTION()
 	void FwdOnConnectError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnConnectError, ErrorMsg);
-	UFUNCTION()
 	void FwdOnDemoConferenceError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnDemoConferenceError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnDisconnected() DLB_DEFINE_FORWARDER(OnDisconnected);
-	UFUNCTION()
 	void FwdOnDisconnectError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnDisconnectError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnSetSpatialEnvironmentScaleError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnSetSpatialEnvironmentScaleError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnMuteInputError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnMuteInputError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnUnmuteInputError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnUnmuteInputError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnMuteOutputError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnMuteOutputError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnUnmuteOutputError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnUnmuteOutputError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnMuteParticipantError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnMuteParticipantError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnUnmuteParticipantError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnUnmuteParticipantError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnParticipantAdded(const EDolbyIOParticipantStatus Status, const FDolbyIOParticipantInfo& ParticipantInfo)
 	    DLB_DEFINE_FORWARDER(OnParticipantAdded, Status, ParticipantInfo);
 
-	UFUNCTION()
 	void FwdOnParticipantUpdated(const EDolbyIOParticipantStatus Status, const FDolbyIOParticipantInfo& ParticipantInfo)
 	    DLB_DEFINE_FORWARDER(OnParticipantUpdated, Status, ParticipantInfo);
 
-	UFUNCTION()
 	void FwdOnRemoteParticipantConnected(const FDolbyIOParticipantInfo& ParticipantInfo)
 	    DLB_DEFINE_FORWARDER(OnRemoteParticipantConnected, ParticipantInfo);
 
-	UFUNCTION()
 	void FwdOnRemoteParticipantDisconnected(const FDolbyIOParticipantInfo& ParticipantInfo)
 	    DLB_DEFINE_FORWARDER(OnRemoteParticipantDisconnected, ParticipantInfo);
 
-	UFUNCTION()
 	void FwdOnLocalParticipantUpdated(const EDolbyIOParticipantStatus Status,
 	                                  const FDolbyIOParticipantInfo& ParticipantInfo)
 	    DLB_DEFINE_FORWARDER(OnLocalParticipantUpdated, Status, ParticipantInfo);
 
-	UFUNCTION()
 	void FwdOnVideoTrackAdded(const FDolbyIOVideoTrack& VideoTrack) DLB_DEFINE_FORWARDER(OnVideoTrackAdded, VideoTrack);
 
-	UFUNCTION()
 	void FwdOnVideoTrackRemoved(const FDolbyIOVideoTrack& VideoTrack)
 	    DLB_DEFINE_FORWARDER(OnVideoTrackRemoved, VideoTrack);
 
-	UFUNCTION()
 	void FwdOnVideoTrackEnabled(const FDolbyIOVideoTrack& VideoTrack)
 	    DLB_DEFINE_FORWARDER(OnVideoTrackEnabled, VideoTrack);
 
-	UFUNCTION()
 	void FwdOnVideoTrackDisabled(const FDolbyIOVideoTrack& VideoTrack)
 	    DLB_DEFINE_FORWARDER(OnVideoTrackDisabled, VideoTrack);
 
-	UFUNCTION()
 	void FwdOnVideoEnabled(const FString& VideoTrackID) DLB_DEFINE_FORWARDER(OnVideoEnabled, VideoTrackID);
-	UFUNCTION()
 	void FwdOnEnableVideoError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnEnableVideoError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnVideoDisabled(const FString& VideoTrackID) DLB_DEFINE_FORWARDER(OnVideoDisabled, VideoTrackID);
-	UFUNCTION()
 	void FwdOnDisableVideoError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnDisableVideoError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnScreenshareSourcesReceived(const TArray<FDolbyIOScreenshareSource>& Sources)
 	    DLB_DEFINE_FORWARDER(OnScreenshareSourcesReceived, Sources);
-	UFUNCTION()
 	void FwdOnGetScreenshareSourcesError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnGetScreenshareSourcesError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnScreenshareStarted(const FString& VideoTrackID) DLB_DEFINE_FORWARDER(OnScreenshareStarted, VideoTrackID);
-	UFUNCTION()
 	void FwdOnStartScreenshareError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnStartScreenshareError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnScreenshareStopped(const FString& VideoTrackID) DLB_DEFINE_FORWARDER(OnScreenshareStopped, VideoTrackID);
-	UFUNCTION()
 	void FwdOnStopScreenshareError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnStopScreenshareError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnChangeScreenshareParametersError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnChangeScreenshareParametersError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnCurrentScreenshareSourceReceived(bool IsNone, const FDolbyIOScreenshareSource& OptionalSource)
 	    DLB_DEFINE_FORWARDER(OnCurrentScreenshareSourceReceived, IsNone, OptionalSource);
-	UFUNCTION()
 	void FwdOnGetCurrentScreenshareSourceError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnGetCurrentScreenshareSourceError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnActiveSpeakersChanged(const TArray<FString>& ActiveSpeakers)
 	    DLB_DEFINE_FORWARDER(OnActiveSpeakersChanged, ActiveSpeakers);
 
-	UFUNCTION()
 	void FwdOnAudioLevelsChanged(const TArray<FString>& ActiveSpeakers, const TArray<float>& AudioLevels)
 	    DLB_DEFINE_FORWARDER(OnAudioLevelsChanged, ActiveSpeakers, AudioLevels);
 
-	UFUNCTION()
 	void FwdOnSetLocalPlayerLocationError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnSetLocalPlayerLocationError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnSetLocalPlayerRotationError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnSetLocalPlayerRotationError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnSetRemotePlayerLocationError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnSetRemotePlayerLocationError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnSetLogSettingsError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnSetLogSettingsError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnAudioInputDevicesReceived(const TArray<FDolbyIOAudioDevice>& Devices)
 	    DLB_DEFINE_FORWARDER(OnAudioInputDevicesReceived, Devices);
-	UFUNCTION()
 	void FwdOnGetAudioInputDevicesError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnGetAudioInputDevicesError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnAudioOutputDevicesReceived(const TArray<FDolbyIOAudioDevice>& Devices)
 	    DLB_DEFINE_FORWARDER(OnAudioOutputDevicesReceived, Devices);
-	UFUNCTION()
 	void FwdOnGetAudioOutputDevicesError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnGetAudioOutputDevicesError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnCurrentAudioInputDeviceReceived(bool IsNone, const FDolbyIOAudioDevice& OptionalDevice)
 	    DLB_DEFINE_FORWARDER(OnCurrentAudioInputDeviceReceived, IsNone, OptionalDevice);
-	UFUNCTION()
 	void FwdOnGetCurrentAudioInputDeviceError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnGetCurrentAudioInputDeviceError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnCurrentAudioOutputDeviceReceived(bool IsNone, const FDolbyIOAudioDevice& OptionalDevice)
 	    DLB_DEFINE_FORWARDER(OnCurrentAudioOutputDeviceReceived, IsNone, OptionalDevice);
-	UFUNCTION()
 	void FwdOnGetCurrentAudioOutputDeviceError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnGetCurrentAudioOutputDeviceError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnVideoDevicesReceived(const TArray<FDolbyIOVideoDevice>& Devices)
 	    DLB_DEFINE_FORWARDER(OnVideoDevicesReceived, Devices);
-	UFUNCTION()
 	void FwdOnGetVideoDevicesError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnGetVideoDevicesError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnCurrentVideoDeviceReceived(bool IsNone, const FDolbyIOVideoDevice& OptionalDevice)
 	    DLB_DEFINE_FORWARDER(OnCurrentVideoDeviceReceived, IsNone, OptionalDevice);
-	UFUNCTION()
 	void FwdOnGetCurrentVideoDeviceError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnGetCurrentVideoDeviceError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnCurrentAudioInputDeviceChanged(bool IsNone, const FDolbyIOAudioDevice& OptionalDevice)
 	    DLB_DEFINE_FORWARDER(OnCurrentAudioInputDeviceChanged, IsNone, OptionalDevice);
-	UFUNCTION()
 	void FwdOnSetAudioInputDeviceError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnSetAudioInputDeviceError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnCurrentAudioOutputDeviceChanged(bool IsNone, const FDolbyIOAudioDevice& OptionalDevice)
 	    DLB_DEFINE_FORWARDER(OnCurrentAudioOutputDeviceChanged, IsNone, OptionalDevice);
-	UFUNCTION()
 	void FwdOnSetAudioOutputDeviceError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnSetAudioOutputDeviceError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnUpdateUserMetadataError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnUpdateUserMetadataError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnSetAudioCaptureModeError(const FString& ErrorMsg)
 	    DLB_DEFINE_FORWARDER(OnSetAudioCaptureModeError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnSendMessageError(const FString& ErrorMsg) DLB_DEFINE_FORWARDER(OnSendMessageError, ErrorMsg);
 
-	UFUNCTION()
 	void FwdOnMessageReceived(const FString& Message, const FDolbyIOParticipantInfo& ParticipantInfo)
 	    DLB_DEFINE_FORWARDER(OnMessageReceived, Message, ParticipantInfo);
 
@@ -32,29 +32,29 @@ inline UDolbyIOSubsystem* GetDolbyIOSubsystem(const UObject* WorldContextObject)
 		return;                                                                    \
 	}
 
-#define DLB_DEFINE_ACTIVATE_METHOD(MethodName, SuccessEvent, ...)                                     \
-	void Activate() override                                                                          \
-	{                                                                                                 \
-		DLB_GET_SUBSYSTEM;                                                                            \
-		DolbyIOSubsystem->SuccessEvent.AddDynamic(this, &UDolbyIO##MethodName::SuccessEvent##Impl);   \
-		DolbyIOSubsystem->On##MethodName##Error.AddDynamic(this, &UDolbyIO##MethodName::OnErrorImpl); \
-		DolbyIOSubsystem->MethodName(__VA_ARGS__);                                                    \
+#define DLB_DEFINE_ACTIVATE_METHOD(MethodName, SuccessEvent, ...)                                             \
+	void Activate() override                                                                                  \
+	{                                                                                                         \
+		DLB_GET_SUBSYSTEM;                                                                                    \
+		DolbyIOSubsystem->SuccessEvent##Native.AddUObject(this, &UDolbyIO##MethodName::SuccessEvent##Impl);   \
+		DolbyIOSubsystem->On##MethodName##Error##Native.AddUObject(this, &UDolbyIO##MethodName::OnErrorImpl); \
+		DolbyIOSubsystem->MethodName(__VA_ARGS__);                                                            \
 	}
 
-#define DLB_DEFINE_IMPL_METHOD(MethodName, SuccessEvent, ...)                                            \
-	{                                                                                                    \
-		SuccessEvent.Broadcast(__VA_ARGS__);                                                             \
-		DLB_GET_SUBSYSTEM;                                                                               \
-		DolbyIOSubsystem->SuccessEvent.RemoveDynamic(this, &UDolbyIO##MethodName::SuccessEvent##Impl);   \
-		DolbyIOSubsystem->On##MethodName##Error.RemoveDynamic(this, &UDolbyIO##MethodName::OnErrorImpl); \
+#define DLB_DEFINE_IMPL_METHOD(MethodName, SuccessEvent, ...)            \
+	{                                                                    \
+		SuccessEvent.Broadcast(__VA_ARGS__);                             \
+		DLB_GET_SUBSYSTEM;                                               \
+		DolbyIOSubsystem->SuccessEvent##Native.RemoveAll(this);          \
+		DolbyIOSubsystem->On##MethodName##Error##Native.RemoveAll(this); \
 	}
 
-#define DLB_DEFINE_ERROR_METHOD(MethodName, SuccessEvent, ...)                                           \
-	{                                                                                                    \
-		OnError.Broadcast(__VA_ARGS__);                                                                  \
-		DLB_GET_SUBSYSTEM;                                                                               \
-		DolbyIOSubsystem->SuccessEvent.RemoveDynamic(this, &UDolbyIO##MethodName::SuccessEvent##Impl);   \
-		DolbyIOSubsystem->On##MethodName##Error.RemoveDynamic(this, &UDolbyIO##MethodName::OnErrorImpl); \
+#define DLB_DEFINE_ERROR_METHOD(MethodName, SuccessEvent, ...)           \
+	{                                                                    \
+		OnError.Broadcast(__VA_ARGS__);                                  \
+		DLB_GET_SUBSYSTEM;                                               \
+		DolbyIOSubsystem->SuccessEvent##Native.RemoveAll(this);          \
+		DolbyIOSubsystem->On##MethodName##Error##Native.RemoveAll(this); \
 	}
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FDolbyIOSetTokenOutputPin, const FString&, ErrorMsg);
@@ -925,6 +925,20 @@ public:
 		DLB_EXECUTE_RETURNING_SUBSYSTEM_METHOD(GetParticipants);
 	}
 
+	/** Gets the latest audio level of a participant, smoothed according to the DolbyIO.AudioLevels.AttackMs and
+	 * DolbyIO.AudioLevels.ReleaseMs console variables. Does not lock or allocate, so it can be called every frame, for
+	 * example to drive lip-sync or a speaking indicator.
+	 *
+	 * @param ParticipantID - The ID of the participant.
+	 * @return The audio level, between 0.0 and 1.0, or 0.0 if the participant is silent or unknown.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Comms",
+	          Meta = (WorldContext = "WorldContextObject", DisplayName = "Dolby.io Get Audio Level"))
+	static float GetAudioLevel(const UObject* WorldContextObject, const FString& ParticipantID)
+	{
+		DLB_EXECUTE_RETURNING_SUBSYSTEM_METHOD(GetAudioLevel, ParticipantID);
+	}
+
 	/** Binds a dynamic material instance to hold the frames of the given video track. The plugin will update the
 	 * material's texture parameter named "DolbyIO Frame" with the necessary data, therefore the material should
 	 * have such a parameter to be usable. Automatically unbinds the material from all other tracks, but it is
@@ -1104,6 +1118,19 @@ public:
 		DLB_EXECUTE_SUBSYSTEM_METHOD(SendMessage, Message, ParticipantIDs);
 	}
 
+	/** Gets the plugin's current performance figures: the resolution, frame rates, dropped frames and conversion cost
+	 * of each video track, the number of events waiting to be broadcast, the texture memory in use, and the rates of
+	 * spatial updates and messages. Cheap enough to be called every frame, rates are averaged over the last second.
+	 *
+	 * @return The performance snapshot.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Dolby.io Comms",
+	          Meta = (WorldContext = "WorldContextObject", DisplayName = "Dolby.io Get Performance Snapshot"))
+	static FDolbyIOPerformanceSnapshot GetPerformanceSnapshot(const UObject* WorldContextObject)
+	{
+		DLB_EXECUTE_RETURNING_SUBSYSTEM_METHOD(GetPerformanceSnapshot);
+	}
+
 	/** Sends a message to all participants in the current conference. The message size is limited to 16KB.
 	 *
 	 * This function calls Send Message with an empty array of selected participants.
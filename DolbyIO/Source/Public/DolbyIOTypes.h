@@ -319,3 +319,125 @@ enum class EDolbyIOVoiceFont : uint8
 	Swarm,
 	AMRadio
 };
+
+/** Performance figures of a video track. Rates are averaged over the last second. */
+USTRUCT(BlueprintType, DisplayName = "Dolby.io Video Track Performance")
+struct DOLBYIO_API FDolbyIOVideoTrackPerformance
+{
+	GENERATED_BODY()
+
+	/** The unique ID of the video track. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	FString TrackID;
+
+	/** The participant from whom the track is coming, empty for local tracks. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	FString ParticipantID;
+
+	/** The width of the latest frame in pixels. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int Width{};
+
+	/** The height of the latest frame in pixels. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int Height{};
+
+	/** The number of frames received per second. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	float InputFps{};
+
+	/** The number of frames uploaded to the texture per second. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	float RenderedFps{};
+
+	/** The factor by which the track's resolution is reduced to fit in the video memory budget. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int DownscaleFactor = 1;
+
+	/** The number of frames received since the track was added. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 ReceivedFrames{};
+
+	/** The number of frames which were never uploaded because a newer frame replaced them. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 DroppedFrames{};
+
+	/** The number of frames whose render request was folded into a pending one. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 CoalescedFrames{};
+
+	/** The average time spent converting a frame, in milliseconds. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	float ConversionMs{};
+
+	/** The memory taken by the track's frame buffers and textures in bytes. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 TextureMemoryBytes{};
+};
+
+/** How many events of a kind which is coalesced before being broadcast were received and broadcast. */
+USTRUCT(BlueprintType, DisplayName = "Dolby.io Event Counters")
+struct DOLBYIO_API FDolbyIOEventCounters
+{
+	GENERATED_BODY()
+
+	/** The name of the event. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	FString Event;
+
+	/** The number of events received from the SDK. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 Received{};
+
+	/** The number of events broadcast, lower than Received when several events were received within one tick. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 Delivered{};
+};
+
+/** Runtime performance figures of the plugin. Rates are averaged over the last second. */
+USTRUCT(BlueprintType, DisplayName = "Dolby.io Performance Snapshot")
+struct DOLBYIO_API FDolbyIOPerformanceSnapshot
+{
+	GENERATED_BODY()
+
+	/** Performance figures of all local and remote video tracks. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	TArray<FDolbyIOVideoTrackPerformance> VideoTracks;
+
+	/** The number of events waiting to be broadcast on the game thread. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int PendingEvents{};
+
+	/** Counters of the events of which only the latest one is broadcast per tick. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	TArray<FDolbyIOEventCounters> CoalescedEvents;
+
+	/** The memory taken by the frame buffers and textures of all video tracks in bytes. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 TextureMemoryBytes{};
+
+	/** The video memory budget set with DolbyIO.Video.MemoryBudgetMB in bytes, 0 if there is no budget. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 VideoMemoryBudgetBytes{};
+
+	/** The memory taken by the textures kept for reuse after their video tracks went away in bytes. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 PooledTextureMemoryBytes{};
+
+	/** The memory allocated by the Dolby.io C++ SDK in bytes. Approximate, since it does not include memory allocated
+	 * while the SDK was being loaded. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	int64 SdkMemoryBytes{};
+
+	/** The number of spatial positions and directions sent per second. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	float SpatialUpdatesPerSecond{};
+
+	/** The number of messages sent per second. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	float MessagesSentPerSecond{};
+
+	/** The number of messages received per second. */
+	UPROPERTY(BlueprintReadOnly, Category = "Dolby.io Comms")
+	float MessagesReceivedPerSecond{};
+};